@@ -47,6 +47,8 @@ private:
     }
     // # playouts
     size_type m_playcount;
+    // Progressive widening {coefficient, exponent}, off if coefficient = 0
+    double m_widening[2];
 public:
     // Construct a tree with 1 node.
     template<class T>
@@ -55,6 +57,7 @@ public:
     {
         std::copy(exploration, exploration + 2, m_exploration);
         initcache();
+        m_widening[0] = m_widening[1] = 0;
     }
     using MCTSTree2::clear;
     using MCTSTree2::data;
@@ -62,6 +65,27 @@ public:
     using MCTSTree2::empty;
     using MCTSTree2::size;
     double const * exploration() const { return m_exploration; }
+    // Turn on progressive widening. A node of size n has at most
+    // max(1, coefficient * n ^ exponent) children.
+    void setwidening(double coefficient, double exponent)
+    { m_widening[0] = coefficient, m_widening[1] = exponent; }
+    double const * widening() const { return m_widening; }
+    // Max # children of a node, under progressive widening
+    size_type widthlimit(TreeNoderef node) const
+    {
+        double const limit(m_widening[0] *
+                           std::pow(node.get().size, m_widening[1]));
+        return limit < 1 ? 1 : static_cast<size_type>(limit);
+    }
+    // Check if a node is ready for a new child from its pending moves.
+    bool canwiden(TreeNoderef node) const
+    {
+        return node.value().haspending() &&
+                node.get().children.size() < widthlimit(node);
+    }
+    // Sort moves by prior, best first, for progressive widening.
+    // Change this to use a cheap prior. The default keeps the game's order.
+    virtual void ordermoves(TreeNoderef, Moves &) const {}
     // Evaluate the root.
     static bool issure(TreeNoderef node) { return node.value().eval().second; }
     bool issure() const { return issure(root()); }
@@ -101,7 +125,7 @@ public:
     bool pickchild(TreeNoderef & node) const
     {
         Children const & children(node.get().children);
-        if (children.empty())
+        if (children.empty() || canwiden(node))
             return false;
         // Find the first unsure child.
         typedef typename Children::const_iterator Iter;
@@ -110,7 +134,7 @@ public:
             if (!issure(*child)) break;
         // If all children are sure, return false.
         if (child == children.end())
-            return false;
+            return false; // Pending moves, if any, are added on expansion.
         // Find the unsure child with largest UCB.
         for (Iter iter(child); iter != children.end(); ++iter)
         {
@@ -146,22 +170,42 @@ public:
     }
     // Evaluate the leaf. Return {value, sure?}.
     virtual Eval evalleaf(TreeNoderef node) const = 0;
+    // Evaluate a node lost so far with moves pending. Return {value, sure?}.
+    // The value should only be WIN or LOSS if it is sure.
+    virtual Eval evalpending(TreeNoderef node) const { return evalleaf(node); }
     // Evaluate the parent. Return {value, sure?}.
     virtual Eval evalparent(TreeNoderef node) const
     {
         double const value(parentval(node));
         return Eval(value, std::abs(value) == WIN);
     }
-    // Evaluate all the new leaves.
-    void evalnewleaves(TreeNoderef node) const
+    // Evaluate all the new leaves, from the child of a given index on.
+    void evalnewleaves(TreeNoderef node, size_type from = 0) const
     {
-        FOR (TreeNoderef child, node.get().children)
+        Children const & children(node.get().children);
+        for (size_type i(from); i < children.size(); ++i)
+        {
+            TreeNoderef child(children[i]);
             if (child.get().children.empty())
                 child.value().eval(evalleaf(child));
+        }
     }
     // Evaluate the node. Return {value, sure?}.
     Eval evaluate(TreeNoderef node) const
-    { return node.get().children.empty() ? evalleaf(node) : evalparent(node); }
+    {
+        if (node.get().children.empty())
+            return evalleaf(node);
+        Eval result(evalparent(node));
+        if (!node.value().haspending())
+            return result;
+        // With moves pending, only a win for the side to move is sure,
+        // and a node lost so far is valued by evalpending.
+        if (result.first == (isourturn(node) ? LOSS : WIN))
+            return evalpending(node);
+        if (result.first != (isourturn(node) ? WIN : LOSS))
+            result.second = false;
+        return result;
+    }
     // Call back for back propagation.
     virtual void backpropcallback(TreeNoderef) {}
     // Back propagate from the node pointed.
@@ -186,8 +230,11 @@ public:
 //std::cout << "Playing out ";
         TreeNoderef node(pickleaf());
 //std::cout << "Expanding " << &node.value() << std::endl;
+        // Under progressive widening, old children are not evaluated again.
+        size_type const from(m_widening[0] > 0 ?
+                             node.get().children.size() : 0);
         if (expand<&Game::moves>(node))
-            evalnewleaves(node);
+            evalnewleaves(node, from);
 //std::cout << "Back propagating." << std::endl;
         backprop(node);
         ++m_playcount;
@@ -210,9 +257,42 @@ public:
     }
     virtual ~MCTS2() {}
 private:
+    // Add children from pending moves, up to the width limit and at least 1.
+    // Return true iff the node has children.
+    bool addpending(TreeNoderef node)
+    {
+        // Keep the pending moves out of the copies made for children.
+        Moves pending;
+        pending.swap(node.value().m_pending);
+        size_type const oldcount(node.get().children.size());
+        while (!pending.empty())
+        {
+            size_type const count(node.get().children.size());
+            if (count > oldcount && count >= widthlimit(node))
+                break;
+            if (node.value().legal(pending.back()))
+            {
+                TreeNoderef child(node.insert(node.value()));
+                child.value().play(pending.back());
+            }
+            pending.pop_back();
+        }
+        pending.swap(node.value().m_pending);
+        return !node.get().children.empty();
+    }
     // Add children. Return true iff new children are found.
     bool addchildren(TreeNoderef node, Moves const & moves)
     {
+        if (m_widening[0] > 0)
+        {
+            // Children must not be relocated, as copies of games may differ.
+            node.reserve(moves.size());
+            Moves & pending(node.value().m_pending);
+            pending = moves;
+            ordermoves(node, pending);
+            std::reverse(pending.begin(), pending.end());
+            return addpending(node);
+        }
 //std::cout << "Adding " << moves.size() << " nodes to " << &node.value();
         node.reserve(moves.size());
         FOR (typename Moves::const_reference move, moves)
@@ -231,11 +311,15 @@ private:
     template<Moves (Game::*)(bool) const>
     bool expand(TreeNoderef node)
     {
+        if (node.value().haspending())
+            return addpending(node);
         return addchildren(node, node.value().moves(isourturn(node)));
     }
     template<Moves (Game::*)(bool, stage_t) const>
     bool expand(TreeNoderef node)
     {
+        if (node.value().haspending())
+            return addpending(node);
         stage_t & stage(node.value().m_stage);
         return addchildren(node, node.value().moves(isourturn(node), stage++));
     }
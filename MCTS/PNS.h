@@ -0,0 +1,178 @@
+#ifndef PNS_H_INCLUDED
+#define PNS_H_INCLUDED
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "statnode.h"
+#include "../util/for.h"
+#include "../util/hash.h"
+
+// Proof-number search tree, for the question whether we can win.
+// Our turn is an OR node, and their turn an AND node.
+template<class Game>
+struct PNS
+{
+    typedef typename Game::Moves Moves;
+    typedef std::size_t size_type;
+    // Proof and disproof numbers
+    typedef std::size_t Number;
+    static Number const INF = std::numeric_limits<Number>::max();
+    // Key of a position in the transposition table, 0 = none
+    typedef util::Hash Key;
+    // Node of the search tree
+    struct TreeNode
+    {
+        State<Game> state;
+        // Pointer to the parent, NULL for the root
+        TreeNode const * parent;
+        // Children, never relocated once added
+        std::vector<TreeNode> children;
+        // # nodes to prove and disprove
+        Number pn, dn;
+        template<class T>
+        TreeNode(T const & game, TreeNode const * p = NULL) :
+            state(game), parent(p), pn(1), dn(1) {}
+        bool issolved() const { return pn == 0 || dn == 0; }
+    };
+private:
+    TreeNode m_root;
+    // # nodes
+    size_type m_size;
+    // Transposition table: key -> proven?, for solved positions
+    std::unordered_map<Key, bool> m_table;
+    // Add with saturation at INF.
+    static Number add(Number x, Number y) { return x >= INF - y ? INF : x + y; }
+    // Set the numbers of a node from an evaluation.
+    void seteval(TreeNode & node, Eval eval) const
+    {
+        if (!eval.second)
+            node.pn = initpn(node), node.dn = 1;
+        else if (eval.first == WIN)
+            node.pn = 0, node.dn = INF;
+        else
+            node.pn = INF, node.dn = 0;
+    }
+    // Set the numbers of an expanded node from its children.
+    // Return true iff they change.
+    bool setnumbers(TreeNode & node)
+    {
+        Number pn(node.state.isourturn() ? INF : 0);
+        Number dn(node.state.isourturn() ? 0 : INF);
+        FOR (TreeNode const & child, node.children)
+        {
+            if (node.state.isourturn())
+                pn = std::min(pn, child.pn), dn = add(dn, child.dn);
+            else
+                pn = add(pn, child.pn), dn = std::min(dn, child.dn);
+        }
+        if (pn == node.pn && dn == node.dn)
+            return false;
+        node.pn = pn, node.dn = dn;
+        if (node.issolved())
+        {
+            if (Key const k = key(node))
+                m_table[k] = node.pn == 0;
+            solvedcallback(node);
+        }
+        return true;
+    }
+    // Moves from a state
+    template<Moves (Game::*)(bool) const>
+    static Moves moves(State<Game> const & state)
+    { return state.moves(state.isourturn()); }
+    template<Moves (Game::*)(bool, stage_t) const>
+    static Moves moves(State<Game> const & state)
+    { return state.moves(state.isourturn(), 0); }
+    // Add the children of a node and evaluate them.
+    // Return true iff the numbers of the node change.
+    bool expand(TreeNode & node)
+    {
+        Moves const & moves(PNS::moves<&Game::moves>(node.state));
+        node.children.reserve(moves.size());
+        FOR (typename Moves::const_reference move, moves)
+        {
+            if (!node.state.legal(move))
+                continue;
+            // The child is made in place, as the game may point to its parent.
+            node.children.emplace_back(node.state, &node);
+            TreeNode & child(node.children.back());
+            child.state.play(move);
+            ++m_size;
+            // Look up the transposition table.
+            Key const k(key(child));
+            typename std::unordered_map<Key, bool>::const_iterator const
+                iter(k ? m_table.find(k) : m_table.end());
+            if (iter != m_table.end())
+                seteval(child, Eval(iter->second ? WIN : LOSS, true));
+            else
+                seteval(child, evalleaf(child));
+            if (child.issolved())
+                solvedcallback(child);
+        }
+        if (!node.children.empty())
+            return setnumbers(node);
+        // Without children, our turn is lost and their turn won.
+        seteval(node, Eval(node.state.isourturn() ? LOSS : WIN, true));
+        if (Key const k = key(node))
+            m_table[k] = node.pn == 0;
+        solvedcallback(node);
+        return true;
+    }
+    // Return the most proving child of an expanded node.
+    static TreeNode & mostproving(TreeNode & node)
+    {
+        TreeNode * best(&node.children.front());
+        FOR (TreeNode & child, node.children)
+            if (node.state.isourturn() ? child.pn < best->pn :
+                child.dn < best->dn)
+                best = &child;
+        return *best;
+    }
+public:
+    // Construct a tree with 1 node.
+    template<class T>
+    PNS(T const & game) : m_root(game), m_size(1) {}
+    TreeNode const & root() const { return m_root; }
+    size_type size() const { return m_size; }
+    bool issolved() const { return m_root.issolved(); }
+    // WIN if proven, LOSS if disproven, 0 otherwise
+    double value() const
+    { return m_root.pn == 0 ? WIN : m_root.dn == 0 ? LOSS : 0; }
+    // Evaluate the leaf. Return {value, sure?}.
+    // A sure value other than WIN counts as disproven.
+    virtual Eval evalleaf(TreeNode const & node) const = 0;
+    // Proof number of an unsolved leaf, at least 1
+    virtual Number initpn(TreeNode const &) const { return 1; }
+    // Key of a position in the transposition table. Return 0 for none.
+    virtual Key key(TreeNode const &) const { return 0; }
+    // Call back for nodes found to be solved.
+    virtual void solvedcallback(TreeNode const &) {}
+    // Search until the root is solved or size limit is reached.
+    void play(size_type sizelimit)
+    {
+        seteval(m_root, evalleaf(m_root));
+        if (m_root.issolved())
+            solvedcallback(m_root);
+        while (!m_root.issolved() && m_size <= sizelimit)
+        {
+            // Select the most proving node.
+            TreeNode * node(&m_root);
+            while (!node->children.empty())
+                node = &mostproving(*node);
+            // Update the ancestors, until the numbers stay the same.
+            for (bool changed(expand(*node)); changed && node->parent; )
+            {
+                node = const_cast<TreeNode *>(node->parent);
+                changed = setnumbers(*node);
+            }
+        }
+    }
+    virtual ~PNS() {}
+};
+
+template<class Game>
+typename PNS<Game>::Number const PNS<Game>::INF;
+
+#endif // PNS_H_INCLUDED
@@ -4,6 +4,9 @@
 #include <algorithm>
 #include "MCTS.h"
 #include "gom.h"
+#if __cplusplus >= 201103L
+#include "PNS.h"
+#endif // __cplusplus
 #include "../util.h"
 #include "../util/for.h"
 
@@ -42,4 +45,22 @@ struct GomSearchTree : MCTS<Gom<M,N,K> >
     }
 };
 
+#if __cplusplus >= 201103L
+// Proof-number search tree for the game
+template<std::size_t M, std::size_t N, std::size_t K>
+struct GomPNS : PNS<Gom<M,N,K> >
+{
+    typedef PNS<Gom<M,N,K> > PNSearch;
+    using typename PNSearch::TreeNode;
+    GomPNS(State<Gom<M,N,K> > const & state) : PNSearch(state) {}
+    // A draw counts as a loss.
+    virtual Eval evalleaf(TreeNode const & node) const
+    {
+        Gom<M,N,K> const & game(node.state.game());
+        int const winner(game.winner());
+        return Eval(winner, winner || game.full());
+    }
+};
+#endif // __cplusplus
+
 #endif // GOMSEARCH_H_INCLUDED
@@ -3,6 +3,9 @@
 
 #include "MCTS.h"
 #include "nim.h"
+#if __cplusplus >= 201103L
+#include "PNS.h"
+#endif // __cplusplus
 
 // Search tree for the game
 template<template<class> class MCTS, std::size_t N>
@@ -24,4 +27,31 @@ struct NimSearchTree : MCTS<Nim<N> >
     }
 };
 
+#if __cplusplus >= 201103L
+// Proof-number search tree for the game
+template<std::size_t N>
+struct NimPNS : PNS<Nim<N> >
+{
+    typedef PNS<Nim<N> > PNSearch;
+    using typename PNSearch::TreeNode;
+    using typename PNSearch::Key;
+    NimPNS(State<Nim<N> > const & state) : PNSearch(state) {}
+    virtual Eval evalleaf(TreeNode const & node) const
+    {
+        State<Nim<N> > const & state(node.state);
+        return state.game().sum() == 0 ? // Game over?
+            Eval(state.isourturn() ? -1 : 1, true) :
+            Eval(0, false);
+    }
+    // Positions are the same if the piles and the turn are.
+    virtual Key key(TreeNode const & node) const
+    {
+        Nim<N> const & game(node.state.game());
+        Key const k(util::hash(util::hash(util::hashbasis, game.piles),
+                               node.state.isourturn()));
+        return k ? k : 1;
+    }
+};
+#endif // __cplusplus
+
 #endif // NIMSEARCH_H_INCLUDED
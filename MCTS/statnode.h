@@ -98,9 +98,20 @@ public:
 template<class Game>
 struct MCTStage : MCTStageBase<Game, Isstaged<Game>::value> {};
 
-// Status node = {node base, Stage}
+// Moves not yet turned into children, for progressive widening
 template<class Game>
-struct StatNode : StatNodeBase<Game>, MCTStage<Game>
+class MCTSPending
+{
+    // Stored in reverse order, the next move last
+    typename Game::Moves m_pending;
+    friend MCTS2<Game>;
+public:
+    bool haspending() const { return !m_pending.empty(); }
+};
+
+// Status node = {node base, Stage, Pending moves}
+template<class Game>
+struct StatNode : StatNodeBase<Game>, MCTStage<Game>, MCTSPending<Game>
 {
     template<class T>
     StatNode(T const & game) : StatNodeBase<Game>(game), MCTStage<Game>() {}
@@ -51,6 +51,15 @@ static bool checknim(std::size_t const * p, std::size_t sizelimit,
     double const value(playgame(tree, sizelimit));
     double const value2(playgame(tree2, sizelimit));
     if (value != value2) return false;
+#if __cplusplus >= 201103L
+    // Progressive widening should not change the value.
+    NimSearchTree<MCTS2,N> tree3(State<Nim<N> >(p),exploration);
+    tree3.setwidening(1, 0.5);
+    if (playgame(tree3, sizelimit) != value) return false;
+    // Nor should proof-number search.
+    NimPNS<N> tree4((State<Nim<N> >(p)));
+    if (playgame(tree4, sizelimit) != value) return false;
+#endif // __cplusplus
     return Nim<N>(p).win() ? value == WIN: value == LOSS;
 }
 
@@ -61,7 +70,15 @@ static double playgom(int * p, std::size_t sizelimit,
 {
     GomSearchTree<MCTS, M,N,K> tree(State<Gom<M,N,K> >(p), exploration);
     GomSearchTree<MCTS2,M,N,K> tree2(State<Gom<M,N,K> >(p),exploration);
-    return playgame(tree, sizelimit), playgame(tree2, sizelimit);
+    playgame(tree, sizelimit);
+    double const value(playgame(tree2, sizelimit));
+#if __cplusplus >= 201103L
+    // Proof-number search only tells a win from the rest.
+    GomPNS<M,N,K> tree3((State<Gom<M,N,K> >(p)));
+    if ((playgame(tree3, sizelimit) == WIN) != (value == WIN))
+        return std::numeric_limits<double>::quiet_NaN();
+#endif // __cplusplus
+    return value;
 }
 
 // Check Monte Carlo tree search.
@@ -84,6 +84,7 @@ void Assertion::sethyps(Assertion const & ass, Bvector const & hypstotrim)
     if (hypstotrim.empty())
         return;
     hypiters.clear(), hypsrPolish.clear(), hypstree.clear();
+    hypsmatcher.clear();
     varsused.clear();
     for (Hypsize i(0); i < ass.hypcount(); ++i)
     {
@@ -104,6 +105,8 @@ void Assertion::sethyps(Assertion const & ass, Bvector const & hypstotrim)
         }
         hypsrPolish.push_back(ass.hypsrPolish[i]);
         hypstree.push_back(ass.hypstree[i]);
+        if (i < ass.hypsmatcher.size())
+            hypsmatcher.push_back(ass.hypsmatcher[i]);
     }
 }
 
@@ -2,6 +2,7 @@
 #define ASS_H_INCLUDED
 
 #include "proof/analyze.h"
+#include "util/hash.h"
 
 // An axiom or a theorem.
 struct Assertion
@@ -31,8 +32,13 @@ struct Assertion
     Prooftree exptree;
     // Proof tree of revPolish of hypotheses
     std::vector<Prooftree> hypstree;
+    // Compiled matchers of revPolish of expression and hypotheses
+    Matchprogram expmatcher;
+    std::vector<Matchprogram> hypsmatcher;
     // Type (propositional, predicate, etc)
     unsigned type;
+    // Hash of the statement, used by the verification cache
+    util::Hash hash;
 // Functions:
     // # of hypotheses
     Hypsize hypcount() const {return hypiters.size();}
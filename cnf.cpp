@@ -6,8 +6,8 @@
 
 std::ostream & operator<<(std::ostream & out, const CNFClauses & cnf)
 {
-    FOR (CNFClause const & clause, cnf)
-        out << clause;
+    FOR (CNFClauses::const_reference clause, cnf)
+        out << CNFClause(clause.begin(), clause.end());
 
     return out;
 }
@@ -20,26 +20,37 @@ void CNFClauses::append
     (CNFClauses const & cnf, Atom const atomcount,
      Literal const * const arglist, Atom const argcount)
 {
-    size_type const oldsize(size());
-    resize(oldsize + cnf.size());
+    m_literals.reserve(m_literals.size() + cnf.m_literals.size());
+    m_ends.reserve(size() + cnf.size());
     // New clauses
-    for (size_type i(0); i < cnf.size(); ++i)
+    FOR (const_reference clause, cnf)
     {
-        (*this)[oldsize + i].resize(cnf[i].size());
-        for (CNFClause::size_type j(0); j < cnf[i].size(); ++j)
-        {
-            Literal const lit(cnf[i][j]);
-            (*this)[oldsize + i][j] = lit / 2 < argcount ?
-            arglist[lit / 2] ^ (lit & 1) : lit + (atomcount - argcount) * 2;
-        }
+        newclause();
+        FOR (Literal const lit, clause)
+            addliteral(lit / 2 < argcount ? arglist[lit / 2] ^ (lit & 1) :
+                       lit + (atomcount - argcount) * 2);
     }
 }
 
+// Append clauses [begin, end) of cnf.
+void CNFClauses::append(CNFClauses const & cnf, size_type begin, size_type end)
+{
+    if (begin >= end)
+        return;
+    // Literals of the clauses
+    size_type const first(begin ? cnf.m_ends[begin - 1] : 0);
+    size_type const offset(m_literals.size());
+    m_literals.insert(m_literals.end(), cnf.m_literals.begin() + first,
+                      cnf.m_literals.begin() + cnf.m_ends[end - 1]);
+    for (size_type i(begin); i < end; ++i)
+        m_ends.push_back(cnf.m_ends[i] - first + offset);
+}
+
 // Check the satisfaction of clause under the model.
 // If UNIT, return (UNIT, index of unassigned literal).
 // If UNDECIDED, return (UNDECIDED, index of unassigned literal).
 std::pair<CNFClausesat, CNFClause::size_type> CNFclausesat
-        (CNFClause const & clause, CNFModel const & model)
+        (CNFClauseview const & clause, CNFModel const & model)
 {
     bool nonefound(false);
     Atom oldatom(0);
@@ -55,7 +66,7 @@ std::pair<CNFClausesat, CNFClause::size_type> CNFclausesat
                 return std::make_pair(UNDECIDED, unitindex);
             nonefound = true;
             oldatom = lit / 2;
-            unitindex = &lit - clause.data();
+            unitindex = &lit - clause.begin();
             continue;
         case CNFTRUE:
             return std::make_pair(SATISFIED, 0u);
@@ -67,6 +78,52 @@ std::pair<CNFClausesat, CNFClause::size_type> CNFclausesat
     return std::make_pair(nonefound ? UNIT : CONTRADICTORY, unitindex);
 }
 
+Atom const CNFModels::modelcount;
+Atom const CNFModels::wordatoms;
+
+// Models extending model, enumerating all values of its first
+// unassigned atoms, at most wordatoms. The rest stay unassigned.
+CNFModels::CNFModels(CNFModel const & model) :
+    assigned(model.size()), values(model.size())
+{
+    Atom i(0);
+    for (Atom atom(0); atom < model.size(); ++atom)
+    {
+        if (model[atom] != CNFNONE)
+            assign(atom * 2 + (model[atom] == CNFFALSE), ~Word(0));
+        else if (i < wordatoms)
+            enumerate(atom, i++);
+    }
+}
+
+// Let atom take all values in the models, the same as bit i of the model #.
+void CNFModels::enumerate(Atom const atom, Atom const i)
+{
+    assigned[atom] = ~Word(0);
+    values[atom] = 0;
+    for (Atom k(0); k < modelcount; ++k)
+        values[atom] |= Word(k >> i & 1) << k;
+}
+
+// Check the satisfaction of clause in all the models at once.
+CNFClausesats CNFclausesat
+    (CNFClauseview const & clause, CNFModels const & models)
+{
+    // Models with >= 1 and >= 2 unassigned literals
+    CNFModels::Word satisfied(0), open1(0), open2(0);
+    FOR (Literal const lit, clause)
+    {
+        CNFModels::Word const open(models.openmodels(lit));
+        satisfied |= models.truemodels(lit);
+        open2 |= open1 & open;
+        open1 |= open;
+    }
+
+    CNFClausesats const result =
+        {satisfied, ~satisfied & open1 & ~open2, ~satisfied & ~open1};
+    return result;
+}
+
 // Move clause to the next UNIT, CONTRADICTORY or UNDECIDED clause.
 // Return (Clausesat, index of unassigned literal).
 std::pair<CNFClausesat, CNFClause::size_type> CNFClauses::nextclause
@@ -100,6 +157,34 @@ std::pair<CNFClausesat, CNFClause::size_type> CNFClauses::nextclause
     return std::make_pair(satisfied ? SATISFIED : UNDECIDED, 0u);
 }
 
+// Propagate unit clauses iteratively in the models in active.
+// Models with a contradiction are removed from active.
+// Return the models in active where all clauses are satisfied.
+CNFModels::Word CNFClauses::unitprop
+    (CNFModels & models, CNFModels::Word & active) const
+{
+    while (true)
+    {
+        bool changed(false);
+        CNFModels::Word satisfied(active);
+        FOR (const_reference clause, *this)
+        {
+            CNFClausesats const sats(CNFclausesat(clause, models));
+            satisfied &= sats.satisfied;
+            active &= ~sats.contradictory;
+            // Models where the clause is unit
+            CNFModels::Word const unit(active & sats.unit);
+            if (!unit)
+                continue;
+            FOR (Literal const lit, clause)
+                models.assign(lit, unit & models.openmodels(lit));
+            changed = true;
+        }
+        if (!changed)
+            return satisfied & active;
+    }
+}
+
 typedef Bvector::size_type TTindex, Mask;
 
 static bool checkmask
@@ -120,8 +205,7 @@ static bool checkmask
 static void addclausefromindexmask
     (Atom atomcount, TTindex index, bool value, Mask mask, CNFClauses & cnf)
 {
-    cnf.resize(cnf.size() + 1);
-    CNFClause & clause(cnf.back());
+    cnf.newclause();
 
     for (Atom i(0); i < atomcount; ++i)
     {
@@ -130,11 +214,11 @@ static void addclausefromindexmask
         // mask[i] = 0. bit = index[i].
         bool const bit(index >> i & 1);
         // Add i if i is false, ~i if i is true.
-        clause.push_back(i * 2 + bit);
+        cnf.addliteral(i * 2 + bit);
     }
 
     // Add positive lit if value is true, negative lit if false
-    clause.push_back(atomcount * 2 + (value ^ 1));
+    cnf.addliteral(atomcount * 2 + (value ^ 1));
 }
 
 // Return a clause covering truthtable[index], and update processed.
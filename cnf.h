@@ -4,19 +4,41 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <climits>
 #include <functional>
+#include <iterator>
 #include <utility>
 #include <vector>
 #include "util/for.h"
-#include "util/filter.h"
 
 // Atom: P = 0, Q = 1, ... Literal: P = 0, !P = 1, Q = 2, !Q = 3, ...
-typedef std::size_t Atom, Literal;
+typedef std::size_t Atom;
+typedef unsigned Literal;
 // Boolean vector
 typedef std::vector<bool> Bvector;
 // A list of literals
 typedef std::vector<Literal> CNFClause;
 
+// Literals of a clause stored elsewhere
+class CNFClauseview
+{
+    Literal const * m_begin, * m_end;
+public:
+    typedef Literal value_type;
+    typedef Literal const & reference, & const_reference;
+    typedef Literal const * iterator, * const_iterator;
+    typedef std::size_t size_type;
+    CNFClauseview(Literal const * begin, Literal const * end) :
+        m_begin(begin), m_end(end) {}
+    CNFClauseview(CNFClause const & clause) :
+        m_begin(clause.data()), m_end(clause.data() + clause.size()) {}
+    const_iterator begin() const { return m_begin; }
+    const_iterator end() const { return m_end; }
+    size_type size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+    const_reference operator[](size_type i) const { return m_begin[i]; }
+};
+
 // Satisfaction of a clause
 enum CNFClausesat{UNDECIDED = -2, UNIT = -1, CONTRADICTORY = 0, SATISFIED = 1};
 // Sense of an individual atom
@@ -40,28 +62,127 @@ struct CNFModel : public std::vector<int>
 // If UNIT, return (UNIT, index of unassigned literal).
 // If UNDECIDED, return (UNDECIDED, index of unassigned literal).
 std::pair<CNFClausesat, CNFClause::size_type> CNFclausesat
-        (CNFClause const & clause, CNFModel const & model);
+        (CNFClauseview const & clause, CNFModel const & model);
+
+// 64 models of an instance, packed one bit for each in a word
+struct CNFModels
+{
+    typedef unsigned long long Word;
+    // # models in a word, and # atoms they enumerate
+    static Atom const modelcount = sizeof(Word) * CHAR_BIT;
+    static Atom const wordatoms = 6;
+    // Models where each atom is assigned, and where it is true
+    std::vector<Word> assigned, values;
+    CNFModels(Atom const n) : assigned(n), values(n) {}
+    // Models extending model, enumerating all values of its first
+    // unassigned atoms, at most wordatoms. The rest stay unassigned.
+    CNFModels(CNFModel const & model);
+    // Models where a literal is true, false or unassigned
+    Word truemodels(Literal const lit) const
+    { return lit % 2 ? assigned[lit / 2] & ~values[lit / 2] : values[lit / 2]; }
+    Word falsemodels(Literal const lit) const { return truemodels(lit ^ 1); }
+    Word openmodels(Literal const lit) const { return ~assigned[lit / 2]; }
+    // Make a literal true in the given models.
+    void assign(Literal const lit, Word const models)
+    {
+        assigned[lit / 2] |= models;
+        if (lit % 2)
+            values[lit / 2] &= ~models;
+        else
+            values[lit / 2] |= models;
+    }
+    // Let atom take all values in the models, the same as bit i of the model #.
+    void enumerate(Atom const atom, Atom const i);
+};
 
-// Instance in conjunctive normal form
-struct CNFClauses : public std::vector<CNFClause>
+// Satisfaction of a clause in 64 models, one bit for each.
+// Models in none of them are undecided.
+struct CNFClausesats
 {
-    CNFClauses(size_type n = 0) : std::vector<CNFClause>(n) {}
+    CNFModels::Word satisfied, unit, contradictory;
+};
+
+// Check the satisfaction of clause in all the models at once.
+CNFClausesats CNFclausesat
+    (CNFClauseview const & clause, CNFModels const & models);
+
+// Instance in conjunctive normal form.
+// The literals of all clauses are stored one after another.
+struct CNFClauses
+{
+    typedef std::size_t size_type;
+    typedef CNFClauseview value_type, reference, const_reference;
+    // Iterator over the clauses
+    class const_iterator
+    {
+        CNFClauses const * m_pcnf;
+        size_type m_index;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef CNFClauseview value_type, reference;
+        typedef CNFClauseview const * pointer;
+        typedef std::ptrdiff_t difference_type;
+        const_iterator(CNFClauses const * pcnf, size_type index) :
+            m_pcnf(pcnf), m_index(index) {}
+        reference operator*() const { return (*m_pcnf)[m_index]; }
+        const_iterator & operator++() { ++m_index; return *this; }
+        const_iterator operator++(int)
+        { const_iterator const old(*this); ++m_index; return old; }
+        bool operator==(const_iterator const & other) const
+        { return m_index == other.m_index; }
+        bool operator!=(const_iterator const & other) const
+        { return m_index != other.m_index; }
+    };
+    typedef const_iterator iterator;
+    CNFClauses() {}
 // Construct the cnf representing a truth table.
     CNFClauses(Bvector const & truthtable);
-    bool hasemptyclause() const { return util::filter(*this)(CNFClause()); }
+    size_type size() const { return m_ends.size(); }
+    bool empty() const { return m_ends.empty(); }
+    const_reference operator[](size_type i) const
+    {
+        Literal const * const data(m_literals.data());
+        return CNFClauseview(data + (i ? m_ends[i - 1] : 0), data + m_ends[i]);
+    }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_reference back() const { return (*this)[size() - 1]; }
+// Add a clause.
+    void push_back(CNFClauseview const & clause)
+    {
+        m_literals.insert(m_literals.end(), clause.begin(), clause.end());
+        m_ends.push_back(m_literals.size());
+    }
+// Start a new empty clause, and add a literal to the last clause.
+    void newclause() { m_ends.push_back(m_literals.size()); }
+    void addliteral(Literal const lit)
+    { m_literals.push_back(lit); ++m_ends.back(); }
+// Roll back to the first n clauses, keeping the space.
+    void truncate(size_type n)
+    {
+        if (n >= size()) return;
+        m_literals.resize(n ? m_ends[n - 1] : 0);
+        m_ends.resize(n);
+    }
+    void clear() { m_literals.clear(); m_ends.clear(); }
+    bool hasemptyclause() const
+    {
+        for (size_type i(0); i < size(); ++i)
+            if (m_ends[i] == (i ? m_ends[i - 1] : 0))
+                return true;
+        return false;
+    }
 // Return # atoms in cnf. Return 1 for empty instance.
     Atom atomcount() const
     {
         // Maximal literal
-        Literal max(0);
-        FOR (const_reference clause, *this)
-        {
-            if (clause.empty()) continue;
-            max = std::max(max,*std::max_element(clause.begin(),clause.end()));
-        }
+        Literal const max(m_literals.empty() ? 0 :
+            *std::max_element(m_literals.begin(), m_literals.end()));
         // Maximal atom + 1
         return max / 2 + 1;
     }
+// Append clauses [begin, end) of cnf.
+    void append(CNFClauses const & cnf, size_type begin, size_type end);
 // Append cnf to the end.
 // If atom < argcount, change it to arglist[atom], with sense adjusted.
 // If atom >= argcount, change it to new atoms starting from atomcount.
@@ -69,9 +190,9 @@ struct CNFClauses : public std::vector<CNFClause>
     void append
         (CNFClauses const & cnf, Atom const atomcount,
          Literal const * const arglist, Atom const argcount);
-// Add a clause containing a single literal/the next atom alone or its negation.
-    void closeoff(Literal lit) { push_back(CNFClause(1, lit)); }
-    void closeoff(bool negate = false) { closeoff((atomcount()-1)*2+negate); }
+// Add a clause containing a single literal/the last atom alone.
+    void closeoff(Literal lit) { newclause(); addliteral(lit); }
+    void closeoff() { closeoff(Literal(atomcount() - 1) * 2); }
 // Return if there is no contradiction in the model so far.
     bool okaysofar(CNFModel const & model) const
     {
@@ -81,6 +202,15 @@ struct CNFClauses : public std::vector<CNFClause>
 
         return true;
     }
+// Return the models with no contradiction so far.
+    CNFModels::Word okaysofar(CNFModels const & models) const
+    {
+        CNFModels::Word okay(~CNFModels::Word(0));
+        for (const_iterator iter(begin()); okay && iter != end(); ++iter)
+            okay &= ~CNFclausesat(*iter, models).contradictory;
+
+        return okay;
+    }
 // Move clause to the next UNIT, CONTRADICTORY or UNDECIDED clause.
 // Return (Clausesat, index of unassigned literal).
     std::pair<CNFClausesat, CNFClause::size_type> nextclause
@@ -98,11 +228,21 @@ struct CNFClauses : public std::vector<CNFClause>
         return unitprop(model, p);
     }
     struct Unitpropcallback { operator bool() const {return true;} };
+// Propagate unit clauses iteratively in the models in active.
+// Models with a contradiction are removed from active.
+// Return the models in active where all clauses are satisfied.
+    CNFModels::Word unitprop
+        (CNFModels & models, CNFModels::Word & active) const;
 // Return if the clauses are satisfiable.
     bool sat() const;
 // Map: free atoms -> truth value.
 // Return the empty vector if not okay.
     Bvector truthtable(Atom const nfree) const;
+private:
+    // Literals of all clauses
+    std::vector<Literal> m_literals;
+    // End of each clause in m_literals
+    std::vector<size_type> m_ends;
 };
 
 template<class T> std::pair<CNFTruthvalue, CNFClauses::size_type>
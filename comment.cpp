@@ -16,25 +16,61 @@ static Token firsttoken(std::string const & str)
         str.substr(begin, str.find_first_of(mmws, begin) - begin);
 }
 
+// Directive type of a comment: 't' or 'j', 0 if not a directive.
+static char commenttype(std::string const & text)
+{
+    Token const token(firsttoken(text));
+    return token.size() == 2 && token[0] == '$' &&
+        (token[1] == 't' || token[1] == 'j') ? token[1] : 0;
+}
+
+// Discouragement ($4.4.1)
+static unsigned discouragement(std::string const & text)
+{
+    static std::string const nouse = "(New usage is discouraged.)";
+    static std::string const nonewproof = "(Proof modification is discouraged.)";
+    return Asstype::NOUSE * (text.find(nouse) < std::string::npos)
+            + Asstype::NONEWPROOF * (text.find(nonewproof) < std::string::npos);
+}
+
+// Classify the comment ($4.4).
+Comment::Comment(std::string const & str, Tokens::size_type pos) :
+    text(str), tokenpos(pos), type(commenttype(str)),
+    discouragement(::discouragement(str)), level(headinglevel(str)),
+    commands(type ? Commands(std::vector<strview>(1, text)) : Commands())
+{
+}
+
+// Check if a comment is a directive of a type.
+static bool istype(Comment const & comment, strview type)
+{
+    return comment.type && type.c_str[0] == '$' &&
+        type.c_str[1] == comment.type && type.c_str[2] == 0;
+}
+
 // Classify comments ($4.4.2 and 4.4.3).
 std::vector<strview> Comments::operator[](strview type) const
 {
     std::vector<strview> result;
 
     FOR (const_reference comment, *this)
-        if (firsttoken(comment.text) == type)
+        if (istype(comment, type))
             result.push_back(comment.text);
 
     return result;
 }
 
-// Discouragement ($4.4.1)
-static unsigned discouragement(std::string const & text)
+// Commands in directives of a type ($4.4.2 and 4.4.3)
+Commands Comments::commands(strview type) const
 {
-    static std::string const nouse = "(New usage is discouraged.)";
-    static std::string const nonewproof = "(Proof modification is discouraged.)";
-    return Asstype::NOUSE * (text.find(nouse) < std::string::npos)
-            + Asstype::NONEWPROOF * (text.find(nonewproof) < std::string::npos);
+    Commands result;
+
+    FOR (const_reference comment, *this)
+        if (istype(comment, type))
+            result.insert(result.end(),
+                          comment.commands.begin(), comment.commands.end());
+
+    return result;
 }
 
 unsigned Comments::discouragement(Tokens::size_type from, Tokens::size_type to) const
@@ -43,8 +79,8 @@ unsigned Comments::discouragement(Tokens::size_type from, Tokens::size_type to)
     unsigned result(0);
     // First comment after from
     const_iterator iter(std::lower_bound(begin(), end(), from));
-    for ( ; iter->tokenpos < to; ++iter)
-        result |= ::discouragement(iter->text);
+    for ( ; iter != end() && iter->tokenpos < to; ++iter)
+        result |= iter->discouragement;
 //std::cout << " with result " << result;
     return result;
 }
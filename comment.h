@@ -4,15 +4,35 @@
 #include <cstddef>
 #include <map>
 #include <vector>
+#include "sect.h"
 #include "token.h"
 #include "typecode.h"
 
 const char mmws[] = "\t\n\f\r "; // metamath whitespace chars ($4.1.1)
 
+typedef std::vector<std::string> Command;
+
+struct Commands : std::vector<Command>
+{
+    Commands(std::vector<strview> const & comments = std::vector<strview>());
+// Classify comments ($4.4.3).
+    Commands operator[](strview type) const;
+};
+
+// A comment, classified when it is read
 struct Comment
 {
     std::string text;
     Tokens::size_type tokenpos;
+    // Directive type ($4.4.2 and 4.4.3): 't' or 'j', 0 if not a directive
+    char type;
+    // Discouragement ($4.4.1)
+    unsigned discouragement;
+    // Level of the section heading, 0 if not a heading ($4.4.1/Headings)
+    Sectionlevel level;
+    // Commands in a directive
+    Commands commands;
+    Comment(std::string const & str = "", Tokens::size_type pos = 0);
     operator Tokens::size_type() const { return tokenpos; }
 };
 
@@ -20,19 +40,12 @@ struct Comments : std::vector<Comment>
 {
 // Classify comments ($4.4.2 and 4.4.3).
     std::vector<strview> operator[](strview type) const;
+// Commands in directives of a type ($4.4.2 and 4.4.3)
+    Commands commands(strview type) const;
 // Discouragement ($4.4.1)
     unsigned discouragement(Tokens::size_type from, Tokens::size_type to) const;
 };
 
-typedef std::vector<std::string> Command;
-
-struct Commands : std::vector<Command>
-{
-    Commands(std::vector<strview> const & comments = std::vector<strview>());
-// Classify comments ($4.4.3).
-    Commands operator[](strview type) const;
-};
-
 // Map: constructor -> definition, or "" if none ($4.4.3)
 struct Ctordefns : std::map<std::string, std::string>
 {
@@ -23,10 +23,20 @@ class Database
     Equalities m_equalities;
     Definitions m_definitions;
     Propctors m_propctors;
+    // Load comment info from $j comments.
+    void loadcommentinfo(Comments const & comments);
 public:
     Database() : m_assvec(1) { addvar(""); }
+    // Read data from tokens. Returns true iff okay.
+    // Proofs found in the cache are not verified again.
+    // If memo is true, syntax subproofs are memoized across theorems.
     bool read(Tokens & tokens, Comments const & comments,
-              Tokens::size_type upto);
+              Tokens::size_type upto, class Verifycache * cache = NULL,
+              bool memo = false);
+    // Read data from tokens fed on the fly, verifying proofs on other threads.
+    // Returns true iff okay.
+    bool read(class Tokenfeed & feed, class Verifycache * cache = NULL,
+              bool memo = false);
     void clear() { this->~Database(); new(this) Database; }
     Symbol2::ID varid(strview str) const { return varIDmap().at(str); }
     VarIDmap const & varIDmap() const { return m_varIDmap; }
@@ -135,8 +145,9 @@ public:
     }
 // Check if all the definitions are syntactically okay.
     bool checkdefinitions() const;
-// Check if all propositional assertions are sound.
-    bool checkpropassertion() const;
+// Check if all propositional assertions are sound, on all hardware threads.
+// Those with at most maxtruthvars variables are checked by truth tables.
+    bool checkpropassertion(Atom maxtruthvars = 12) const;
 // Print all hard assertions.
     void printhardassertions() const;
 };
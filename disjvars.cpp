@@ -44,8 +44,8 @@ static bool checkdisjvars
         FOR (Symbol3 var2, set2)
             if (!checkdisjvars(var1, var2, disjvars))
             {
-                std::cerr << var1 << " and " << var2
-                          << " violate the disjoint variable hypothesis\n";
+                util::msgerr() << var1 << " and " << var2
+                               << " violate the disjoint variable hypothesis\n";
                 return false;
             }
 
@@ -75,9 +75,9 @@ bool checkdisjvars
 
     if (!is_disjoint(set1.begin(), set1.end(), set2.begin(), set2.end()))
     {
-        std::cerr << "Expression\n" << Expression(begin1, end1) << "and"
-                  << "Expression\n" << Expression(begin2, end2) << "have"
-                  << "have a common variable" << std::endl;
+        util::msgerr() << "Expression\n" << Expression(begin1, end1) << "and"
+                       << "Expression\n" << Expression(begin2, end2) << "have"
+                       << "have a common variable" << std::endl;
         return false;
     }
     // Check disjoint variable hypotheses on used variables.
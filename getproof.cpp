@@ -2,8 +2,10 @@
 #include <cctype>
 #include "util/for.h"
 #include "io.h"
-#include "proof.h"
+#include "getproof.h"
+#include "proof/step.h"
 #include "token.h"
+#include "util/mute.h"
 
 // Determine if there is no more token before finishing a statement.
 bool unfinishedstat(Tokens const & tokens, strview stattype, strview label)
@@ -19,7 +21,8 @@ int printbadprooferr(strview label, int err)
 {
     static const char * const prefix[] = {"Warning: incomplete", "Error: no"};
     if (err != 1)
-        std::cerr << prefix[err + 1] << " proof for theorem " << label << '\n';
+        util::msgerr() << prefix[err + 1] << " proof for theorem " << label
+                       << '\n';
     return err;
 }
 
@@ -38,11 +41,74 @@ static char badproofletters(strview token)
     return s == end ? 0 : *s;
 }
 
-// Get sequence of letters in a compressed proof (Appendix B).
+// Subroutine for calculating proof number. Returns true iff okay.
+template<unsigned MUL>
+static bool addproofnumber(Proofnumber & num, int add)
+{
+    static const Proofnumber size_max(-1);
+
+    if (num > size_max / MUL || MUL * num > size_max - add)
+        return false;
+
+    num = MUL * num + add;
+    return true;
+}
+
+// Errors in decoding a compressed proof, reported after all letters are read
+enum {DECODEOKAY, NUMOVERFLOW, STRAYZ, UNFINISHED};
+
+// Decode a letter of a compressed proof (Appendix B).
+// When a number is complete, add its proof step.
+// Return 0 if okay. Otherwise return the error code.
+static int decodeproofletter
+    (char c, Proofsteps const & labels, Proofnumber & num, bool & justgotnum,
+     Proofsteps & steps)
+{
+    if (c <= 'T')
+    {
+        if (!addproofnumber<20>(num, c - ('A' - 1)))
+            return NUMOVERFLOW;
+
+        Proofsize const labelcount(labels.size());
+        steps.push_back(num <= labelcount ? labels[num - 1] :
+                        Proofstep(num - labelcount - 1));
+        num = 0u;
+        justgotnum = true;
+    }
+    else if (c <= 'Y')
+    {
+        if (!addproofnumber<5>(num, c - 'T'))
+            return NUMOVERFLOW;
+
+        justgotnum = false;
+    }
+    else // It must be Z
+    {
+        if (!justgotnum)
+            return STRAYZ;
+
+        steps.push_back(Proofstep(Proofstep::SAVE));
+        justgotnum = false;
+    }
+
+    return DECODEOKAY;
+}
+
+// Decode the letters of a compressed proof (Appendix B) into proof steps,
+// as they are read from the tokens. The letter Z is translated as SAVE.
+// Discard tokens up to and including $.
 // Returns 1 if Okay, 0 on error, -1 if the proof is incomplete.
-int getproofletters(strview label, Tokens & tokens, std::string & proof)
+int getproofsteps
+    (strview label, Tokens & tokens, Proofsteps const & labels,
+     Proofsteps & steps)
 {
     strview token;
+    bool empty(true), incomplete(false);
+    // Number being decoded
+    Proofnumber num(0u);
+    bool justgotnum(false);
+    // First decoding error
+    int err(DECODEOKAY);
 
     while (!tokens.empty() && (token = tokens.front()) != "$.")
     {
@@ -54,7 +120,14 @@ int getproofletters(strview label, Tokens & tokens, std::string & proof)
             return 0;
         }
 
-        proof += token.c_str;
+        for (const char * s(token.c_str); *s; ++s)
+        {
+            empty = false;
+            if (*s == '?')
+                incomplete = true;
+            else if (!incomplete && !err)
+                err = decodeproofletter(*s, labels, num, justgotnum, steps);
+        }
         tokens.pop();
     }
 
@@ -63,74 +136,27 @@ int getproofletters(strview label, Tokens & tokens, std::string & proof)
 
     tokens.pop(); // Discard $. token
 
-    return printbadprooferr(label, proof.empty() ? 0 :
-                            proof.find('?') != Token::npos ? -1 : 1);
-}
+    if (empty || incomplete)
+        return printbadprooferr(label, empty ? 0 : -1);
 
-// Subroutine for calculating proof number. Returns true iff okay.
-template<unsigned MUL>
-static bool addproofnumber(Proofnumber & num, int add, strview label)
-{
-    static const Proofnumber size_max(-1);
+    if (!err && num != 0u)
+        err = UNFINISHED;
 
-    if (num > size_max / MUL || MUL * num > size_max - add)
+    switch (err)
     {
+    case NUMOVERFLOW:
         std::cerr << "Overflow computing numbers in compressed proof of "
                   << label << std::endl;
-        return false;
-    }
-
-    num = MUL * num + add;
-    return true;
-}
-
-// Get the raw numbers from compressed proof format.
-// The letter Z is translated as 0 (Appendix B).
-Proofnumbers getproofnumbers(strview label, std::string const & proof)
-{
-    Proofnumbers result;
-    result.reserve(proof.size()); // Preallocate for efficiency
-
-    std::size_t num(0u);
-    bool justgotnum(false);
-    FOR (char c, proof)
-    {
-        if (c <= 'T')
-        {
-            if (!addproofnumber<20>(num, c - ('A' - 1), label))
-                return Proofnumbers();
-
-            result.push_back(num);
-            num = 0u;
-            justgotnum = true;
-        }
-        else if (c <= 'Y')
-        {
-            if (!addproofnumber<5>(num, c - 'T', label))
-                return Proofnumbers();
-
-            justgotnum = false;
-        }
-        else // It must be Z
-        {
-            if (!justgotnum)
-            {
-                std::cerr << "Stray Z found in compressed proof of "
-                          << label << std::endl;
-                return Proofnumbers();
-            }
-
-            result.push_back(0u);
-            justgotnum = false;
-        }
-    }
-
-    if (num != 0u)
-    {
+        return 0;
+    case STRAYZ:
+        std::cerr << "Stray Z found in compressed proof of "
+                  << label << std::endl;
+        return 0;
+    case UNFINISHED:
         std::cerr << "Compressed proof of theorem " << label
                   << " ends in unfinished number" << std::endl;
-        return Proofnumbers();
+        return 0;
     }
 
-    return result;
+    return 1;
 }
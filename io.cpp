@@ -12,7 +12,7 @@ bool is1stle2nd(std::size_t const n, std::size_t const lim,
 {
     if (n <= lim)
         return true;
-    std::cout << n << s1 << lim << s2 << std::endl;
+    util::msgout() << n << s1 << lim << s2 << std::endl;
     return false;
 }
 
@@ -20,7 +20,7 @@ bool is1stle2nd(std::size_t const n, std::size_t const lim,
 void printass(std::size_t number, strview label, std::size_t count)
 {
     if (count != 0)
-        std::cout << count;
+        util::msgout() << count;
 
-    std::cout << "\t#" << number << '\t' << label << '\t';
+    util::msgout() << "\t#" << number << '\t' << label << '\t';
 }
@@ -9,6 +9,7 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "util/mute.h"
 
 struct strview;
 std::ostream & operator<<(std::ostream & out, strview str);
@@ -47,7 +48,7 @@ template<class T>
 bool unexpected(bool const condition, const char * const type, const T & value)
 {
     if (condition)
-        std::cerr << "Unexpected " << type << ": " << value << std::endl;
+        util::msgerr() << "Unexpected " << type << ": " << value << std::endl;
 
     return condition;
 }
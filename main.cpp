@@ -30,53 +30,179 @@
 // Please let me know of any bugs.
 
 //#include <fstream>
+#include <cstring>
 #include "database.h"
+#include <thread>
 #include "io.h"
+#include "pipeline.h"
+#include "proof/cache.h"
+#include "sat.h"
 #include "search/prop.h"
+#include "search/stats.h"
 #include "sect.h"
 #include "test.h"
+#include "util/filter.h"
+#include "util/for.h"
 #include "util/timer.h"
 
     Database database;
 
+// Options of the form --name or --name=value: name -> value
+typedef std::map<std::string, std::string> Options;
+
+// Separate options from the other arguments. Return the other arguments.
+static std::vector<const char *> getoptions
+    (int argc, char ** argv, Options & options)
+{
+    std::vector<const char *> args;
+    for (int i(1); i < argc; ++i)
+    {
+        const char * const arg(argv[i]);
+        if (std::strncmp(arg, "--", 2) != 0)
+        {
+            args.push_back(arg);
+            continue;
+        }
+        const char * const equal(std::strchr(arg, '='));
+        if (equal)
+            options[std::string(arg + 2, equal)] = equal + 1;
+        else
+            options[arg + 2];
+    }
+    return args;
+}
+
+// Names of all the options
+static const char * const optionnames[] =
+    {"cache", "memo", "pipeline", "sat", "satstats", "search", "stats",
+     "widen"};
+
+// Check if all the options are known. Report the unknown ones.
+static bool checkoptions(Options const & options)
+{
+    bool okay(true);
+    FOR (Options::const_reference option, options)
+        if (!util::filter(optionnames)(option.first))
+        {
+            std::cerr << "Unknown option --" << option.first << std::endl;
+            okay = false;
+        }
+    return okay;
+}
+
+// Read the file and the data in a pipeline. Returns true iff okay.
+static bool readpipelined
+    (const char * filename, Tokens & tokens, Comments & comments,
+     Verifycache * cache, bool memo)
+{
+    Tokenqueue queue(1 << 4);
+    bool lexed(false);
+    std::thread lexer([&]() { lexed = read(filename, queue); });
+    Tokenfeed feed(queue, tokens, comments);
+    bool const okay(database.read(feed, cache, memo));
+    // Stop the lexer if reading stopped early.
+    queue.close();
+    lexer.join();
+    return okay && lexed;
+}
+
 int main(int argc, char ** argv)
 {
-    if (argc < 2)
+    Options options;
+    std::vector<const char *> const & args(getoptions(argc, argv, options));
+    if (!checkoptions(options) || args.empty())
     {
-        std::cerr << "Syntax: mmprfass <filename> [<section title>]\n";
+        std::cerr << "Syntax: mmprfass [--cache[=<file>]] [--pipeline] [--memo] "
+                     "[--stats[=<file>]] [--search=mcts|pn] [--sat=<solver>] "
+                     "[--satstats] [--widen] <filename> [<section title>]\n";
         return EXIT_FAILURE;
     }
 
     if (!pretest())
         return EXIT_FAILURE;
 
+    // Cache of verified proofs
+    Verifycache cache;
+    std::string cachefile;
+    if (options.count("cache"))
+    {
+        cachefile = options["cache"].empty() ? std::string(args[0]) + ".cache" :
+                    options["cache"];
+        if (!cache.load(cachefile.c_str()))
+            return EXIT_FAILURE;
+    }
+    Verifycache * const pcache(cachefile.empty() ? NULL : &cache);
+    // Memoize syntax subproofs in verification.
+    bool const memo(options.count("memo"));
+    // Proof search engine, mcts by default
+    std::string const & engine(options["search"]);
+    if (!engine.empty() && engine != "mcts" && engine != "pn")
+    {
+        std::cerr << "Unknown search engine " << engine << std::endl;
+        return EXIT_FAILURE;
+    }
+    // SAT solver, dpll by default
+    if (options.count("sat") && !setsatsolver(options["sat"]))
+    {
+        std::cerr << "Unknown SAT solver " << options["sat"] << ". Try";
+        FOR (Satsolvers::const_reference solver, satsolvers())
+            std::cerr << ' ' << solver.first;
+        std::cerr << std::endl;
+        return EXIT_FAILURE;
+    }
+    // Statistics of SAT calls, off by default to keep the calls cheap
+    satstats().enabled = options.count("satstats");
+
     Tokens tokens;
     Comments comments;
-    std::cout << "Reading file ... ";
     Timer timer;
-    // Read tokens. Returns true iff okay.
-    bool read(const char * const filename, Tokens & tokens, Comments & comments);
-    if (!read(argv[1], tokens, comments))
-        return EXIT_FAILURE;
-    std::cout << "done in " << timer << 's' << std::endl;
+    // Reading up to a section needs all the comments first.
+    bool const pipelined(options.count("pipeline") && args.size() == 1);
+    if (pipelined)
+    {
+        std::cout << "Reading file and data in a pipeline";
+        if (!readpipelined(args[0], tokens, comments, pcache, memo))
+            return EXIT_FAILURE;
+        std::cout << "done in " << timer << 's' << std::endl;
+    }
+    else
+    {
+        std::cout << "Reading file ... ";
+        // Read tokens. Returns true iff okay.
+        bool read(const char * const filename, Tokens & tokens, Comments & comments);
+        if (!read(args[0], tokens, comments))
+            return EXIT_FAILURE;
+        std::cout << "done in " << timer << 's' << std::endl;
+    }
 
     Sections sections(comments);
     if (!sections.empty())
         std::cout << "Last section: " << sections.rbegin()->first
                   << sections.rbegin()->second;
 
-    tokens.position = 0;
-    // Iterator to the end section
-    Sections::const_iterator const end
-        (argv[2] ? sections.find(argv[2]) : sections.end());
-    // # tokens to read
-    Tokens::size_type const size(end == sections.end() ? tokens.size() :
-                                 end->second.tokenpos());
-    std::cout << "Reading and verifying data";
-    timer.reset();
-    if (!database.read(tokens, comments, size))
-        return EXIT_FAILURE;
-    std::cout << "done in " << timer << 's' << std::endl;
+    if (!pipelined)
+    {
+        tokens.position = 0;
+        // Iterator to the end section
+        Sections::const_iterator const end
+            (args.size() > 1 ? sections.find(args[1]) : sections.end());
+        // # tokens to read
+        Tokens::size_type const size(end == sections.end() ? tokens.size() :
+                                     end->second.tokenpos());
+        std::cout << "Reading and verifying data";
+        timer.reset();
+        if (!database.read(tokens, comments, size, pcache, memo))
+            return EXIT_FAILURE;
+        std::cout << "done in " << timer << 's' << std::endl;
+    }
+
+    if (pcache)
+    {
+        std::cout << cache.hits() << '/' << cache.size()
+                  << " proofs found in verification cache" << std::endl;
+        if (!cache.save(cachefile.c_str()))
+            return EXIT_FAILURE;
+    }
 
     if (!sections.empty())
         std::cout << "Last section: " << sections.rbegin()->first << std::endl;
@@ -119,10 +245,29 @@ int main(int argc, char ** argv)
 
     double parameters[] = {0, 1e-3, 0};
 //    parameters[2] = SearchBase::STAGED;
+    // Progressive widening of the moves tried in MCTS
+    if (options.count("widen"))
+        parameters[2] = SearchBase::WIDEN;
+    if (engine == "pn")
+        parameters[2] = SearchBase::PN;
+    // Statistics of assertions, learned across searches
+    Assstats stats;
+    std::string statsfile;
+    if (options.count("stats"))
+    {
+        statsfile = options["stats"].empty() ? std::string(args[0]) + ".stats" :
+                    options["stats"];
+        if (!stats.load(statsfile.c_str(), database.assertions()))
+            return EXIT_FAILURE;
+    }
+    Assstats * const pstats(statsfile.empty() ? NULL : &stats);
 //Uncomment the next two lines if you want to output to a file.
 //    std::ofstream out("result.txt");
 //    std::basic_streambuf<char> * sb(std::cout.rdbuf(out.rdbuf()));
-    if (!testpropsearch(database, 1 << 10, parameters))
+    if (!testpropsearch(database, 1 << 10, parameters, pstats,
+                        options.count("satstats")))
+        return EXIT_FAILURE;
+    if (pstats && !stats.save(statsfile.c_str()))
         return EXIT_FAILURE;
 //Also please uncomment this line, or you will get a segmentation fault.
 //    std::cout.rdbuf(sb);
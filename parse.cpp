@@ -71,8 +71,8 @@ static bool checkdisjvars
                                   pframe2->begin, pframe2->itersub->first,
                                   disjvars));
     if (!okay)
-        std::cerr << "in substitutions for " << pframe1->var
-                  << " and " << pframe2->var << std::endl;
+        util::msgerr() << "in substitutions for " << pframe1->var
+                       << " and " << pframe2->var << std::endl;
     return okay;
 }
 
@@ -147,18 +147,98 @@ static bool nextsubframe
      // Track the substitutions for variables.
      Substack & stack, Substframe::Subexpends & result);
 
+Subexprecords::Subexprecords
+    (Expression const & exp, Syntaxioms const & syntaxioms) : m_exp(exp)
+{
+    // Group syntax axioms by type, keeping their order.
+    FOR (Syntaxioms::const_reference syntaxiom, syntaxioms)
+    {
+        Assiter const assiter(syntaxiom.second.assiter);
+        Expression const & saexp(assiter->second.expression);
+        if (saexp.empty())
+            continue;
+        Typerecords * p(find(saexp[0]));
+        if (!p)
+        {
+            m_types.push_back(Typerecords());
+            p = &m_types.back();
+            p->type = saexp[0];
+        }
+        if (saexp.size() > 1 && isconst(saexp[1]))
+            p->constfirst[saexp[1]]; // Seen constant
+        else
+            p->varfirst.push_back(assiter);
+    }
+    // Index syntax axioms by the constant they begin with.
+    FOR (Syntaxioms::const_reference syntaxiom, syntaxioms)
+    {
+        Assiter const assiter(syntaxiom.second.assiter);
+        Expression const & saexp(assiter->second.expression);
+        if (saexp.empty())
+            continue;
+        Typerecords & records(*find(saexp[0]));
+        FOR (Typerecords::Constfirst::reference r, records.constfirst)
+            if (saexp.size() == 1 || isvar(saexp[1]) || saexp[1] == r.first)
+                r.second.push_back(assiter);
+    }
+}
+
+Subexprecords::Typerecords * Subexprecords::find(strview type)
+{
+    FOR (Typerecords & records, m_types)
+        if (records.type == type)
+            return &records;
+    return NULL;
+}
+
+Subexprecords::Typerecords const * Subexprecords::find(strview type) const
+{
+    FOR (Typerecords const & records, m_types)
+        if (records.type == type)
+            return &records;
+    return NULL;
+}
+
+// Return the record of parses of the type starting at begin.
+Subexprecords::Record & Subexprecords::operator()(strview type, Expiter begin)
+{
+    Typerecords * p(find(type));
+    if (!p)
+    {
+        // Type without syntax axioms
+        m_types.push_back(Typerecords());
+        p = &m_types.back();
+        p->type = type;
+    }
+    // Reserve space for substitutions from begin to end, inclusive.
+    if (p->records.empty())
+        p->records.resize(m_exp.size() + 1);
+    return p->records[begin - m_exp.begin()];
+}
+
+// Return syntax axioms of the type which may match at begin.
+Subexprecords::Candidates const & Subexprecords::candidates
+    (strview type, Expiter begin) const
+{
+    static Candidates const none;
+    Typerecords const * p(find(type));
+    if (!p)
+        return none;
+    if (begin == m_exp.end() || isvar(*begin))
+        return p->varfirst;
+    Typerecords::Constfirst::const_iterator const
+        iter(p->constfirst.find(*begin));
+    return iter == p->constfirst.end() ? p->varfirst : iter->second;
+}
+
 // Return possible substitutions from begin to end of the given type.
 Substframe::Subexpends const & rPolishmap
     (strview type, Expiter expbegin, Expiter expend,
      Expression const & exp, Disjvars const & disjvars,
      struct Syntaxioms const & syntaxioms, Subexprecords & recs)
 {
-    // Reserve space for substitutions from begin to end, inclusive.
-    recs[type].resize(exp.size() + 1);
-
     // Check if expbegin has been seen before.
-    std::pair<Substframe::Subexpends, bool> & iter
-        (recs[type][expbegin - exp.begin()]);
+    Subexprecords::Record & iter(recs(type, expbegin));
     if (iter.second)
         // Yes. Return the recorded result.
         return iter.first;
@@ -171,14 +251,10 @@ Substframe::Subexpends const & rPolishmap
         expbegin->typecode() == type)
         result[expbegin + 1].assign(1, expbegin->phyp);
 
-    // Match syntax axioms.
-    FOR (Syntaxioms::const_reference syntaxiom, syntaxioms)
+    // Match syntax axioms of the type.
+    FOR (Assiter assiter, recs.candidates(type, expbegin))
     {
-        Assiter assiter(syntaxiom.second.assiter);
-        Expression const & saexp(assiter->second.expression);
-        if (saexp.empty() || saexp[0] != type)
-            continue; // Type mismatch
-//std::cout << "Matching " << syntaxiom.first
+//std::cout << "Matching " << assiter->first
 //          << " against " << Expression(expbegin, expend);
         Substack stack;
         do
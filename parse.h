@@ -1,6 +1,7 @@
 #ifndef PARSE_H_INCLUDED
 #define PARSE_H_INCLUDED
 
+#include <deque>
 #include "proof/step.h"
 
 // Stack frame used to find all substitutions in a syntax axiom.
@@ -21,9 +22,39 @@ struct Substframe
     { return !unexpected(itersub == ends.end(), "substitution for", var);}
 };
 
-// Map: type -> vector[begin index] = possible ends of substitutions.
-typedef std::map<strview,
-    std::vector<std::pair<Substframe::Subexpends, bool> > > Subexprecords;
+// Memo of parses of an expression, indexed by type and begin index.
+// Syntax axioms are indexed by type and first symbol.
+class Subexprecords
+{
+public:
+    // (Map: end of substitution -> its revPolish notation, is filled)
+    typedef std::pair<Substframe::Subexpends, bool> Record;
+    // Syntax axioms to be matched
+    typedef std::vector<Assiter> Candidates;
+    Subexprecords(Expression const & exp, struct Syntaxioms const & syntaxioms);
+    // Return the record of parses of the type starting at begin.
+    Record & operator()(strview type, Expiter begin);
+    // Return syntax axioms of the type which may match at begin.
+    Candidates const & candidates(strview type, Expiter begin) const;
+private:
+    struct Typerecords
+    {
+        strview type;
+        // Records indexed by begin index
+        std::vector<Record> records;
+        // Syntax axioms beginning with a variable
+        Candidates varfirst;
+        // Map: constant -> syntax axioms beginning with it or with a variable
+        typedef std::map<strview, Candidates> Constfirst;
+        Constfirst constfirst;
+    };
+    Expression const & m_exp;
+    // There are only a few types, so a linear search is fast.
+    // Records must not move when a new type is added.
+    std::deque<Typerecords> m_types;
+    Typerecords * find(strview type);
+    Typerecords const * find(strview type) const;
+};
 
 // Return possible substitutions from begin to end of the given type.
 Substframe::Subexpends const & rPolishmap
@@ -0,0 +1,104 @@
+#include <utility>
+#include "ass.h"
+#include "pipeline.h"
+#include "proof/cache.h"
+#include "proof/verify.h"
+#include "util/for.h"
+#include "util/mute.h"
+
+// Append the next batch. Return false if there is none.
+bool Tokenfeed::refill()
+{
+    Tokenbatch batch;
+    if (!m_queue.pop(batch))
+        return false;
+
+    FOR (Token & token, batch.tokens)
+        m_tokens.push_back(std::move(token));
+    FOR (Comment & comment, batch.comments)
+        m_comments.push_back(std::move(comment));
+
+    return true;
+}
+
+// Verify proofs from the queue until it is closed.
+// If memo is true, each worker memoizes syntax subproofs.
+void Verifypool::work(bool memo)
+{
+    util::Mute mute;
+    Subproofmemo subproofmemo;
+    Task * ptask;
+    while (m_queue.pop(ptask))
+    {
+        if (ptask->index > m_failed)
+            continue; // Skip proofs after a bad one.
+        Assertions::const_reference ass(*ptask->iter);
+        Expression const & exp(verifyproofsteps(ptask->steps, &ass,
+                                                memo ? &subproofmemo : NULL));
+        ptask->okay = provesrightthing(ass.first, exp, ass.second.expression);
+        if (ptask->okay)
+            continue;
+        // Record the least bad index.
+        std::size_t least(m_failed);
+        while (ptask->index < least &&
+               !m_failed.compare_exchange_weak(least, ptask->index))
+            ;
+    }
+}
+
+// Start the worker threads. 0 = one per hardware thread.
+Verifypool::Verifypool(unsigned threadcount, bool memo) :
+    m_queue(1 << 10), m_failed(static_cast<std::size_t>(-1))
+{
+    if (threadcount == 0)
+        threadcount = std::thread::hardware_concurrency();
+    if (threadcount == 0)
+        threadcount = 1;
+
+    for (unsigned i(0); i < threadcount; ++i)
+        m_workers.push_back(std::thread(&Verifypool::work, this, memo));
+}
+
+// Add a proof to be verified. The steps are moved into the pool.
+// Return false if an earlier proof is bad, when reading should stop.
+bool Verifypool::add(Assertions::iterator iter, Proofsteps & steps, util::Hash hash)
+{
+    if (m_failed < m_tasks.size())
+        return false;
+    Task const task = {iter, Proofsteps(), hash, m_tasks.size(), false};
+    m_tasks.push_back(task);
+    m_tasks.back().steps.swap(steps);
+    m_queue.push(&m_tasks.back());
+    return true;
+}
+
+// Wait for all the proofs to be verified, and store the verified ones.
+// Return true iff all proofs are okay. Otherwise print the messages of
+// the first bad proof.
+bool Verifypool::finish(Verifycache * cache)
+{
+    m_queue.close();
+    FOR (std::thread & worker, m_workers)
+        worker.join();
+    m_workers.clear();
+
+    // Stop at the first bad proof in file order.
+    bool okay(true);
+    FOR (Task & task, m_tasks)
+    {
+        if (!(okay = task.okay))
+        {
+            // Verify it again to print the messages.
+            Assertions::const_reference ass(*task.iter);
+            Expression const & exp(verifyproofsteps(task.steps, &ass));
+            provesrightthing(ass.first, exp, ass.second.expression);
+            break;
+        }
+        task.iter->second.proofsteps.swap(task.steps);
+        if (cache)
+            cache->add(task.iter->first, task.hash);
+    }
+    m_tasks.clear();
+
+    return okay;
+}
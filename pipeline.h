@@ -0,0 +1,79 @@
+#ifndef PIPELINE_H_INCLUDED
+#define PIPELINE_H_INCLUDED
+
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+#include "comment.h"
+#include "proof/step.h"
+#include "util/hash.h"
+#include "util/queue.h"
+
+// Tokens and comments read by the lexer, ending at a statement boundary
+struct Tokenbatch
+{
+    std::vector<Token> tokens;
+    // Positions are counted from the beginning of the file.
+    Comments comments;
+};
+
+// Queue of token batches from the lexer to the statement parser
+typedef util::Boundedqueue<Tokenbatch> Tokenqueue;
+
+// Read tokens in batches into the queue, and close the queue.
+// Returns true iff okay.
+bool read(const char * const filename, Tokenqueue & queue);
+
+// Batches from a queue, appended to the tokens and comments as needed
+class Tokenfeed
+{
+    Tokenqueue & m_queue;
+    Tokens & m_tokens;
+    Comments & m_comments;
+public:
+    Tokenfeed(Tokenqueue & queue, Tokens & tokens, Comments & comments) :
+        m_queue(queue), m_tokens(tokens), m_comments(comments) {}
+    Tokens & tokens() { return m_tokens; }
+    Comments & comments() { return m_comments; }
+    // Append the next batch. Return false if there is none.
+    bool refill();
+};
+
+// Pool of threads verifying proofs while the parser reads on.
+// Workers print nothing. Once a proof fails, later proofs are skipped,
+// and only the messages of the first bad proof in file order are printed.
+class Verifypool
+{
+    struct Task
+    {
+        Assertions::iterator iter;
+        Proofsteps steps;
+        util::Hash hash;
+        // Position in the order the tasks are added
+        std::size_t index;
+        bool okay;
+    };
+    // Tasks in the order they are added
+    std::deque<Task> m_tasks;
+    util::Boundedqueue<Task *> m_queue;
+    std::vector<std::thread> m_workers;
+    // Index of the first task found bad, or -1 if there is none
+    std::atomic<std::size_t> m_failed;
+    // Verify proofs from the queue until it is closed.
+    // If memo is true, each worker memoizes syntax subproofs.
+    void work(bool memo);
+public:
+    // Start the worker threads. 0 = one per hardware thread.
+    Verifypool(unsigned threadcount = 0, bool memo = false);
+    ~Verifypool() { finish(); }
+    // Add a proof to be verified. The steps are moved into the pool.
+    // Return false if an earlier proof is bad, when reading should stop.
+    bool add(Assertions::iterator iter, Proofsteps & steps, util::Hash hash);
+    // Wait for all the proofs to be verified, and store the verified ones.
+    // Return true iff all proofs are okay. Otherwise print the messages of
+    // the first bad proof.
+    bool finish(class Verifycache * cache = NULL);
+};
+
+#endif // PIPELINE_H_INCLUDED
@@ -8,91 +8,84 @@
 #include "../util.h"
 #include "verify.h"
 
-// Subroutine for proof tree building.
-// Process a proof step referencing an assertion (i.e., not a hypothesis).
-// Add the corresponding step to the proof tree.
-// Return true if okay.
-static bool treeassertionref
-    (Assertion const & assertion, std::vector<Proofsize> & stack,
-     Prooftree::reference step)
+// Build the tree of the steps in place, reusing the space.
+// Return true iff okay. Leave the tree empty if not okay.
+bool Prooftree::assign(Proofsteps const & steps)
 {
-    Hypsize const hypcount(assertion.hypcount());
-    if (!enoughitemonstack(hypcount, stack.size(), ""))
-        return false;
-
-    Prooftreehyps::size_type const base(stack.size() - hypcount);
-    Proofsize const index(stack.empty() ? 0 : stack.back() + 1);
-    step.assign(stack.begin() + base, stack.end());
-    // Remove hypotheses from stack.
-    stack.erase(stack.begin() + base, stack.end());
-    // Add conclusion to stack.
-    stack.push_back(index);
-
-    return true;
-}
-
-// Return the proof tree. For the step proof[i],
-// Retval[i] = {index of root of arg1, index of root of arg2, ...}
-// Return empty tree if not okay. Only for uncompressed proofs
-Prooftree prooftree(Proofsteps const & steps)
-{
-    std::vector<Proofsize> stack;
-    // Preallocate for efficiency
-    stack.reserve(steps.size());
-    Prooftree tree(steps.size());
+    clear();
+    m_offsets.reserve(steps.size() + 1);
+    m_begins.reserve(steps.size());
+    m_offsets.push_back(0);
 
     for (Proofsize i(0); i < steps.size(); ++i)
     {
-        Proofstep::Type type(steps[i].type);
+        Proofstep::Type const type(steps[i].type);
         if (type == Proofstep::HYP)
-            stack.push_back(i);
-        else if (type == Proofstep::ASS &&
-                 treeassertionref(steps[i].pass->second, stack, tree[i]))
+        {
+            m_offsets.push_back(m_hyps.size());
+            m_begins.push_back(i);
             continue;
-        else return Prooftree();
+        }
+        if (type != Proofstep::ASS)
+            return clear(), false;
+        // Find the roots of the hypotheses, from the last one.
+        Hypsize const hypcount(steps[i].pass->second.hypcount());
+        m_hyps.resize(m_hyps.size() + hypcount);
+        Proofsize begin(i);
+        Hypsize j(hypcount);
+        for ( ; j > 0 && begin > 0; --j)
+        {
+            m_hyps[m_hyps.size() - hypcount + j - 1] = begin - 1;
+            begin = m_begins[begin - 1];
+        }
+        if (j > 0)
+        {
+            // Not enough subtrees
+            enoughitemonstack(hypcount, hypcount - j, "");
+            return clear(), false;
+        }
+        m_offsets.push_back(m_hyps.size());
+        m_begins.push_back(begin);
     }
 
-    return stack.size() == 1 ? tree : Prooftree();
+    // The steps should form one tree.
+    if (steps.empty() || m_begins.back() != 0)
+        return clear(), false;
+    return true;
 }
 
-// Iterator to a proof tree node
-typedef Prooftree::const_iterator Treeiter;
-// Find the beginning of the subtree with root iter.
-static Treeiter subproofbegins(Treeiter iter)
+// Build the tree of steps [begin, end) of another tree in place.
+// The steps must form complete subtrees.
+void Prooftree::assign(Prooftree const & tree, Proofsize begin, Proofsize end)
 {
-    while (!iter->empty())
-        iter -= iter->back() - iter->front() + 1;
-    return iter;
+    clear();
+    m_offsets.push_back(0);
+    for (Proofsize i(begin); i < end; ++i)
+    {
+        FOR (Proofsize hyp, tree[i])
+            m_hyps.push_back(hyp - begin);
+        m_offsets.push_back(m_hyps.size());
+        m_begins.push_back(tree.begin(i) - begin);
+    }
 }
 
-// Return the indentations of all the proofs in a proof tree.
-static void indentation(Treeiter begin, Treeiter end,
+// Return the indentations of all the proofs in the subtree with root.
+static void indentation(Prooftree const & tree, Proofsize root,
                         std::vector<Proofsize> & result)
 {
-    // Iterator to root of subtree
-    Treeiter const back(end - 1);
-    if (back->empty())
-        return;
-    // Index and level of root
-    Proofsize const index(back->back() + 1), level(result[index]);
-    for (Prooftreehyps::size_type i(0); i < back->size(); ++i)
+    FOR (Proofsize subroot, tree[root])
     {
-        // Index of root of sub tree
-        Proofsize const subroot((*back)[i]);
         // Indent one more level.
-        result[subroot] = level + 1;
+        result[subroot] = result[root] + 1;
         // Recurse to the subtree.
-        Treeiter const newend(end - (index - subroot));
-        Treeiter const newbegin(i == 0 ? begin :
-                                end - (index - (*back)[i - 1]));
-        indentation(newbegin, newend, result);
+        indentation(tree, subroot, result);
     }
 }
 std::vector<Proofsize> indentation(Prooftree const & tree)
 {
     std::vector<Proofsize> result(tree.size());
     if (!tree.empty())
-        indentation(tree.begin(), tree.end(), result);
+        indentation(tree, tree.size() - 1, result);
     return result;
 }
 
@@ -128,8 +121,7 @@ Proof splitproof
         }
 
         // Process the node. Find the corresponding subproof.
-        Prfiter const begin(proof.begin() +
-                            (subproofbegins(tree.begin() + node)-tree.begin()));
+        Prfiter const begin(proof.begin() + tree.begin(node));
         Prfiter const end(proof.begin() + node + 1);
         // Numbering of subproof.
         Subprfs::size_type i(0);
@@ -184,13 +176,8 @@ Subprfs splitassumptions
                 (proof.begin() + begin, proof.begin() + tree[wistep][i] + 1);
 //std::cout << "Split subproof: " << subproof;
             // Extract the corresponding subtree.
-            Prooftree subtree(subproof.size());
-            for (Proofsize j(0); j < subproof.size(); ++j)
-            {
-                subtree[j].resize(tree[begin + j].size());
-                for (Prooftreehyps::size_type k(0); k < tree[begin + j].size(); ++k)
-                    subtree[j][k] = tree[begin + j][k] - begin;
-            }
+            Prooftree subtree;
+            subtree.assign(tree, begin, begin + subproof.size());
             // Split the assumption according to "and" connectives.
             Subprfs::size_type const oldsize(result.size());
             splitproof(subproof, subtree, ands, result);
@@ -214,15 +201,14 @@ Subprfs splitassumptions
     return result;
 }
 
-// Check if the rPolish of an expression matches a template.
+// Check if the subtree of the rPolish of an expression with root exproot
+// matches the subtree of a template with root patternroot.
 static bool findsubstitutions
-    (Stepiter expbegin, Stepiter expend, Treeiter exptree,
-     Stepiter templatebegin, Stepiter templateend, Treeiter templatetree,
-     Subprfsteps & result)
+    (Proofsteps const & exp, Prooftree const & exptree, Proofsize exproot,
+     Proofsteps const & pattern, Prooftree const & patterntree,
+     Proofsize patternroot, Subprfsteps & result)
 {
-//std::cout << "Matching " << Proofsteps(expbegin, expend);
-//std::cout << "Against " << Proofsteps(templatebegin, templateend);
-    Proofstep expback(*(expend - 1)), templateback(*(templateend - 1));
+    Proofstep const & expback(exp[exproot]), templateback(pattern[patternroot]);
     switch(templateback.type)
     {
     case Proofstep::HYP:
@@ -231,6 +217,8 @@ static bool findsubstitutions
 //std::cout << "Var " << templateback << " ID = " << id << std::endl;
             if (id == 0)
                 return false;
+            Stepiter const expbegin(exp.begin() + exptree.begin(exproot));
+            Stepiter const expend(exp.begin() + exproot + 1);
             // Template hypothesis is floating. Check if it has been seen.
             if (result[id].second > result[id].first)
                 return util::equal(expbegin, expend,
@@ -244,35 +232,16 @@ static bool findsubstitutions
             return false;
         // Check the children.
         {
-            // Ends of both trees
-            Treeiter exptreeend(expend - expbegin + exptree);
-            Treeiter tmptreeend(templateend - templatebegin + templatetree);
-            // Backs of both trees
-            Prooftreehyps const & exptreeback(*(exptreeend - 1));
-            Prooftreehyps const & tmptreeback(*(tmptreeend - 1));
-//std::cout << exptreeback << std::endl << tmptreeback << std::endl;
-            if (exptreeback.size() != tmptreeback.size())
+            Prooftreehyps const exphyps(exptree[exproot]);
+            Prooftreehyps const patternhyps(patterntree[patternroot]);
+            if (exphyps.size() != patternhyps.size())
                 return false; // Children size mismatch
             // Match the children.
-            for (Prooftreehyps::size_type i(0); i < exptreeback.size(); ++i)
-            {
-                Treeiter newexptree(i == 0 ? subproofbegins(exptreeend - 1) :
-                                    exptreeend - 1 -
-                                    (exptreeback.back() - exptreeback[i - 1]));
-                Stepiter newexpbegin(expbegin + (newexptree - exptree));
-                Stepiter newexpend(expend - 1 -
-                                   (exptreeback.back() - exptreeback[i]));
-                Treeiter newtmptree(i == 0 ? subproofbegins(tmptreeend - 1) :
-                                    tmptreeend - 1 -
-                                    (tmptreeback.back() - tmptreeback[i - 1]));
-                Stepiter newtmpbegin(templatebegin + (newtmptree - templatetree));
-                Stepiter newtmpend(templateend - 1 -
-                                   (tmptreeback.back() - tmptreeback[i]));
-                if (!findsubstitutions(newexpbegin, newexpend, newexptree,
-                                       newtmpbegin, newtmpend, newtmptree,
+            for (Prooftreehyps::size_type i(0); i < exphyps.size(); ++i)
+                if (!findsubstitutions(exp, exptree, exphyps[i],
+                                       pattern, patterntree, patternhyps[i],
                                        result))
                     return false;
-            }
             return true;
         }
     default:
@@ -291,7 +260,79 @@ bool findsubstitutions
     if (exp.empty() || exp.size() != exptree.size() ||
         pattern.empty() || pattern.size() != patterntree.size())
         return false;
-    return findsubstitutions(exp.begin(), exp.end(), exptree.begin(),
-                             pattern.begin(), pattern.end(), patterntree.begin(),
-                             result);
+    return findsubstitutions(exp, exptree, exp.size() - 1,
+                             pattern, patterntree, pattern.size() - 1, result);
+}
+
+// Add the steps of the subtree with root index to the program in preorder.
+static void matchprogram
+    (Proofsteps const & pattern, Prooftree const & tree, Proofsize root,
+     Matchprogram & program)
+{
+    program.push_back(pattern[root]);
+    FOR (Proofsize child, tree[root])
+        matchprogram(pattern, tree, child, program);
+}
+
+// Compile the rPolish of a pattern for matching.
+Matchprogram matchprogram(Proofsteps const & pattern, Prooftree const & tree)
+{
+    Matchprogram program;
+    if (pattern.empty() || pattern.size() != tree.size())
+        return program;
+    program.reserve(pattern.size());
+    matchprogram(pattern, tree, pattern.size() - 1, program);
+    return program;
+}
+
+// Check if the rPolish of an expression matches a compiled template.
+bool findsubstitutions
+    (Proofsteps const & exp, Prooftree const & exptree,
+     Matchprogram const & program, Subprfsteps & result)
+{
+    if (exp.empty() || exp.size() != exptree.size() || program.empty())
+        return false;
+
+    // Stack of (begin, end) of subtrees of exp yet to be matched
+    typedef std::pair<Proofsize, Proofsize> Span;
+    thread_local static std::vector<Span> stack;
+    stack.assign(1, Span(0, exp.size()));
+
+    FOR (Proofstep const & step, program)
+    {
+        if (stack.empty())
+            return false;
+        Span const span(stack.back());
+        stack.pop_back();
+        if (step.type == Proofstep::HYP)
+        {
+            Symbol2::ID const id(step.id());
+            if (id == 0)
+                return false;
+            Stepiter const begin(exp.begin() + span.first);
+            Stepiter const end(exp.begin() + span.second);
+            // Check if the variable has been seen.
+            if (result[id].second > result[id].first)
+            {
+                if (!util::equal(begin, end, result[id].first, result[id].second))
+                    return false;
+            }
+            else
+                result[id] = Subprfstep(begin, end);
+            continue;
+        }
+        if (step.type != Proofstep::ASS)
+            return false;
+        // Assertion step. Match the root.
+        Proofsize const root(span.second - 1);
+        if (exp[root] != step)
+            return false;
+        // Push the children, the first one on top.
+        Prooftreehyps const children(exptree[root]);
+        for (Prooftreehyps::size_type i(children.size()); i > 0; --i)
+            stack.push_back(Span(i == 1 ? span.first : children[i - 2] + 1,
+                                 children[i - 1] + 1));
+    }
+
+    return stack.empty();
 }
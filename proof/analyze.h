@@ -3,10 +3,63 @@
 
 #include "step.h"
 
-// All hypotheses in the proof tree used for a proof step
-typedef std::vector<Proofsize> Prooftreehyps;
-// Tree structure of the steps of a proof
-typedef std::vector<Prooftreehyps> Prooftree;
+// All hypotheses in the proof tree used for a proof step,
+// viewed as indices of their roots
+class Prooftreehyps
+{
+    const Proofsize * m_begin, * m_end;
+public:
+    typedef Proofsize value_type;
+    typedef std::size_t size_type;
+    typedef const Proofsize * iterator, * const_iterator;
+    Prooftreehyps(const Proofsize * begin, const Proofsize * end) :
+        m_begin(begin), m_end(end) {}
+    size_type size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+    Proofsize operator[](size_type i) const { return m_begin[i]; }
+    Proofsize front() const { return *m_begin; }
+    Proofsize back() const { return m_end[-1]; }
+    const_iterator begin() const { return m_begin; }
+    const_iterator end() const { return m_end; }
+};
+
+// Tree structure of the steps of a proof,
+// with the hypotheses of all the steps in one array
+class Prooftree
+{
+    // Indices of roots of hypotheses of all the steps
+    std::vector<Proofsize> m_hyps;
+    // Hypotheses of step i = m_hyps[m_offsets[i], m_offsets[i + 1])
+    std::vector<Proofsize> m_offsets;
+    // Index of the first step of the subtree with root i
+    std::vector<Proofsize> m_begins;
+public:
+    typedef Proofsize size_type;
+    Prooftree() {}
+    // Build the tree of the steps. Leave the tree empty if not okay.
+    explicit Prooftree(Proofsteps const & steps) { assign(steps); }
+    // Build the tree of the steps in place, reusing the space.
+    // Return true iff okay. Leave the tree empty if not okay.
+    bool assign(Proofsteps const & steps);
+    // Build the tree of steps [begin, end) of another tree in place.
+    // The steps must form complete subtrees.
+    void assign(Prooftree const & tree, Proofsize begin, Proofsize end);
+    size_type size() const { return m_begins.size(); }
+    bool empty() const { return m_begins.empty(); }
+    void clear() { m_hyps.clear(), m_offsets.clear(), m_begins.clear(); }
+    Prooftreehyps operator[](size_type i) const
+    {
+        const Proofsize * const hyps(m_hyps.data());
+        return Prooftreehyps(hyps + m_offsets[i], hyps + m_offsets[i + 1]);
+    }
+    Prooftreehyps back() const { return (*this)[size() - 1]; }
+    // Index of the first step of the subtree with root i
+    Proofsize begin(size_type i) const { return m_begins[i]; }
+};
+// Pattern compiled for matching: its steps in preorder.
+// An assertion step matches a subtree with the same root,
+// and a floating hypothesis step binds a variable to a subtree.
+typedef std::vector<Proofstep> Matchprogram;
 // Begin and end of a subproof
 typedef std::pair<Prfiter, Prfiter> Subprf;
 // A sequence of subproofs
@@ -27,7 +80,10 @@ inline bool isonestep(Proofsteps const & steps)
 // Return the proof tree. For the step proof[i],
 // Retval[i] = {index of hyp1, index of hyp2, ...}
 // Return empty tree if not okay. Only for uncompressed proofs
-Prooftree prooftree(Proofsteps const & steps);
+inline Prooftree prooftree(Proofsteps const & steps)
+{
+    return Prooftree(steps);
+}
 
 // Return the indentations of all the proofs in a proof tree.
 std::vector<Proofsize> indentation(Prooftree const & tree);
@@ -54,4 +110,12 @@ bool findsubstitutions
      Proofsteps const & pattern, Prooftree const & patterntree,
      Subprfsteps & result);
 
+// Compile the rPolish of a pattern for matching.
+Matchprogram matchprogram(Proofsteps const & pattern, Prooftree const & tree);
+
+// Check if the rPolish of an expression matches a compiled template.
+bool findsubstitutions
+    (Proofsteps const & exp, Prooftree const & exptree,
+     Matchprogram const & program, Subprfsteps & result);
+
 #endif // ANALYZE_H_INCLUDED
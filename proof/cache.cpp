@@ -0,0 +1,118 @@
+#include <fstream>
+#include <iostream>
+#include "../ass.h"
+#include "../util/for.h"
+#include "cache.h"
+
+// Hash an expression into h.
+static util::Hash hash(util::Hash h, Expression const & exp)
+{
+    h = util::hash(h, exp.size());
+    FOR (Symbol3 symbol, exp)
+        h = util::hash(h, symbol.c_str);
+    return h;
+}
+
+// Hash of a hypothesis, including its label
+util::Hash hypothesishash(Hypotheses::const_reference hyp)
+{
+    util::Hash const h(util::hash(util::hashbasis, hyp.first.c_str));
+    return hash(util::hash(h, hyp.second.second), hyp.second.first);
+}
+
+// Hash of the statement of an assertion, i.e., its label, expression,
+// mandatory hypotheses and disjoint variable restrictions.
+util::Hash statementhash(Assertions::const_reference ass)
+{
+    util::Hash h(util::hash(util::hashbasis, ass.first.c_str));
+    h = hash(h, ass.second.expression);
+    h = util::hash(h, ass.second.hypcount());
+    FOR (Hypiter iter, ass.second.hypiters)
+        h = util::hash(h, hypothesishash(*iter));
+    h = util::hash(h, ass.second.disjvars.size());
+    FOR (Disjvars::const_reference dv, ass.second.disjvars)
+        h = util::hash(util::hash(h, dv.first.c_str), dv.second.c_str);
+    return h;
+}
+
+// Hash of a proof, including the statements of all the referenced
+// assertions and hypotheses. It changes iff the proof has to be verified again.
+util::Hash proofhash(util::Hash statementhash, Proofsteps const & steps)
+{
+    util::Hash h(util::hash(statementhash, steps.size()));
+    FOR (Proofstep step, steps)
+    {
+        h = util::hash(h, static_cast<int>(step.type));
+        switch (step.type)
+        {
+        case Proofstep::HYP:
+            h = util::hash(h, hypothesishash(*step.phyp));
+            break;
+        case Proofstep::ASS:
+            h = util::hash(h, step.pass->second.hash);
+            break;
+        case Proofstep::LOAD:
+            h = util::hash(h, step.index);
+            break;
+        default:
+            break;
+        }
+    }
+    return h;
+}
+
+// Load the cache from a file. Return true iff okay.
+// A missing file is treated as an empty cache.
+bool Verifycache::load(const char * filename)
+{
+    m_loaded.clear();
+    std::ifstream in(filename);
+    if (!in.is_open())
+        return true;
+
+    std::string label;
+    util::Hash hash;
+    while (in >> label >> std::hex >> hash >> std::dec)
+        m_loaded[label] = hash;
+
+    if (!in.eof())
+    {
+        std::cerr << "Bad entry after " << label << " in verification cache "
+                  << filename << std::endl;
+        m_loaded.clear();
+        return false;
+    }
+
+    return true;
+}
+
+// Save the cache to a file. Return true iff okay.
+bool Verifycache::save(const char * filename) const
+{
+    std::ofstream out(filename);
+    FOR (Map::const_reference entry, m_verified)
+        out << entry.first << ' ' << std::hex << entry.second << std::dec << '\n';
+    out.flush();
+
+    if (!out.good())
+    {
+        std::cerr << "Could not write verification cache " << filename
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Check if the proof of a theorem has been verified with the same hash.
+// Return true iff it has. Record the proof as verified if it has.
+bool Verifycache::hit(strview label, util::Hash hash)
+{
+    Map::const_iterator const iter(m_loaded.find(label.c_str));
+    if (iter == m_loaded.end() || iter->second != hash)
+        return false;
+
+    add(label, hash);
+    ++m_hits;
+    return true;
+}
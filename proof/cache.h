@@ -0,0 +1,46 @@
+#ifndef CACHE_H_INCLUDED
+#define CACHE_H_INCLUDED
+
+#include <string>
+#include "step.h"
+#include "../util/hash.h"
+
+// Hash of a hypothesis, including its label
+util::Hash hypothesishash(Hypotheses::const_reference hyp);
+// Hash of the statement of an assertion, i.e., its label, expression,
+// mandatory hypotheses and disjoint variable restrictions.
+util::Hash statementhash(Assertions::const_reference ass);
+// Hash of a proof, including the statements of all the referenced
+// assertions and hypotheses. It changes iff the proof has to be verified again.
+util::Hash proofhash(util::Hash statementhash, Proofsteps const & steps);
+
+// Cache of verified proofs: label of theorem -> proof hash
+class Verifycache
+{
+    typedef std::map<std::string, util::Hash> Map;
+    // Entries loaded from file
+    Map m_loaded;
+    // Entries verified in this run
+    Map m_verified;
+    // # proofs found in the cache
+    Map::size_type m_hits;
+public:
+    Verifycache() : m_hits(0) {}
+    // Load the cache from a file. Return true iff okay.
+    // A missing file is treated as an empty cache.
+    bool load(const char * filename);
+    // Save the cache to a file. Return true iff okay.
+    bool save(const char * filename) const;
+    // Check if the proof of a theorem has been verified with the same hash.
+    // Return true iff it has. Record the proof as verified if it has.
+    bool hit(strview label, util::Hash hash);
+    // Record the proof of a theorem as verified.
+    void add(strview label, util::Hash hash) { m_verified[label.c_str] = hash; }
+    // Start another run, loading the proofs verified in this run,
+    // as if the cache were saved and loaded again.
+    void rerun() { m_loaded.swap(m_verified); m_verified.clear(); m_hits = 0; }
+    Map::size_type hits() const { return m_hits; }
+    Map::size_type size() const { return m_verified.size(); }
+};
+
+#endif // CACHE_H_INCLUDED
@@ -3,6 +3,7 @@
 #include "../scope.h"
 #include "step.h"
 #include "../util/for.h"
+#include "../util/mute.h"
 
 const char proofsteperr[] = "Invalid proof step ";
 
@@ -25,7 +26,7 @@ Proofstep::operator const char*() const
     case ASS:
         return pass->first.c_str;
     default:
-        std::cerr << proofsteperr << "of type " << type << std::endl;
+        util::msgerr() << proofsteperr << "of type " << type << std::endl;
     }
     return NULL;
 }
@@ -41,7 +42,7 @@ Proofstep Proofstep::Builder::operator()(strview label) const
     if (iterass != m_assertions.end())
         return Proofstep(&*iterass); // assertion
 
-    std::cerr << proofsteperr << label.c_str << std::endl;
+    util::msgerr() << proofsteperr << label.c_str << std::endl;
     return Proofstep::NONE;
 }
 
@@ -5,29 +5,12 @@
 #include "../msg.h"
 #include "../util/arith.h"
 #include "../util/filter.h"
+#include "../util/hash.h"
 #include "verify.h"
 
 // Substitution vector
 typedef std::vector<std::pair<const Symbol3 *, const Symbol3 *> > Substitutions;
 
-// Extract proof steps from a compressed proof.
-Proofsteps compressedproofsteps
-    (Proofsteps const & labels, Proofnumbers const & proofnumbers)
-{
-    Proofsteps result(proofnumbers.size()); // Preallocate for efficiency
-    Proofsize const labelcount(labels.size());
-
-    for (Proofnumbers::size_type step(0); step < proofnumbers.size(); ++step)
-    {
-        Proofnumbers::value_type const number(proofnumbers[step]);
-        result[step] = number == 0 ? Proofstep(Proofstep::SAVE) :
-                        number <= labelcount ? labels[number - 1] :
-                            Proofstep(number - labelcount - 1);
-    }
-
-    return result;
-}
-
 // Extract proof steps from a regular proof.
 Proofsteps regularproofsteps
     (Proof const & proof,
@@ -43,7 +26,7 @@ Proofsteps regularproofsteps
 static bool printinproofof(strview thlabel, bool okay = false)
 {
     if (!okay)
-        std::cerr << " in proof of theorem " << thlabel << std::endl;
+        util::msgerr() << " in proof of theorem " << thlabel << std::endl;
     return okay;
 }
 
@@ -60,20 +43,21 @@ void printunificationfailure
     (strview thlabel, strview reflabel, Hypothesis const & hyp,
      Expression const & dest, Expression const & stackitem)
 {
-    std::cout << "In step " << reflabel; printinproofof(thlabel);
-    std::cout << (hyp.second ? "floating" : "essential")
-              << " hypothesis " << hyp.first << "expanded to\n" << dest
-              << "does not match stack item\n" << stackitem;
+    util::msgout() << "In step " << reflabel; printinproofof(thlabel);
+    util::msgout() << (hyp.second ? "floating" : "essential")
+                   << " hypothesis " << hyp.first << "expanded to\n" << dest
+                   << "does not match stack item\n" << stackitem;
 }
 
 static void printdisjvarserr
     (strview var1,Expression const & exp1,strview var2,Expression const & exp2,
      Disjvars const & disjvars)
 {
-    std::cerr << "The substitutions\n" << var1 << ":\t" << exp1
-              << var2 << ":\t" << exp2
-              << "violate disjoint variable hypothesis.\n"
-              << "The theorem's disjoint variable hypotheses:\n" << disjvars;
+    util::msgerr() << "The substitutions\n" << var1 << ":\t" << exp1
+                   << var2 << ":\t" << exp2
+                   << "violate disjoint variable hypothesis.\n"
+                   << "The theorem's disjoint variable hypotheses:\n"
+                   << disjvars;
 }
 
 // Check disjoint variable hypothesis in verifying an assertion reference.
@@ -99,11 +83,177 @@ static bool checkdisjvars
     return true;
 }
 
+// Checker of disjoint variable hypotheses, with a bitmask of variables
+// for each item on the stack, over IDs local to the proof.
+// Does nothing if there is no theorem.
+class Disjchecker
+{
+    typedef unsigned long long Word;
+    static const std::size_t wordbits = 64;
+    // Map: ID of variable -> local ID + 1, or 0 if not in the proof
+    std::vector<Proofsize> m_local;
+    // # words in a mask, 0 if there is no theorem
+    std::size_t m_stride;
+    // Mask of variables used in the theorem
+    std::vector<Word> m_used;
+    // Row i = mask of variables disjoint from local variable i
+    std::vector<Word> m_rows;
+    // Masks of items on the stack, and of saved steps
+    std::vector<Word> m_stack, m_saved;
+    // Map: ID of variable -> index of its floating hypothesis
+    std::vector<Hypsize> m_hypindex;
+    // Local ID of a variable, or -1 if not in the proof
+    Proofsize local(Symbol2::ID id) const
+    { return id < m_local.size() ? m_local[id] - 1 : Proofsize(-1); }
+    void setbit(Word * mask, Proofsize i) const
+    { mask[i / wordbits] |= Word(1) << i % wordbits; }
+    // Add an empty mask to the end.
+    Word * addmask(std::vector<Word> & masks) const
+    {
+        masks.resize(masks.size() + m_stride);
+        return &masks[masks.size() - m_stride];
+    }
+    Word const * stackmask(std::size_t item) const
+    { return &m_stack[item * m_stride]; }
+public:
+    Disjchecker(Proofsteps const & steps, Assptr pthm);
+    // Push the mask of a hypothesis onto the stack.
+    void pushhyp(Expression const & exp)
+    {
+        if (m_stride == 0)
+            return;
+        Word * const mask(addmask(m_stack));
+        FOR (Symbol3 var, exp)
+            if (var.id)
+                setbit(mask, local(var.id));
+    }
+    void load(Proofstep::Index index)
+    {
+        if (m_stride == 0)
+            return;
+        Word * const mask(addmask(m_stack));
+        std::copy(&m_saved[index * m_stride], &m_saved[index * m_stride] +
+                  m_stride, mask);
+    }
+    void save()
+    {
+        if (m_stride == 0)
+            return;
+        Word * const mask(addmask(m_saved));
+        std::copy(m_stack.end() - m_stride, m_stack.end(), mask);
+    }
+    // Check the disjoint variable hypotheses of an assertion referenced,
+    // with hypotheses on top of the stack.
+    // If okay, replace the hypotheses by the conclusion.
+    bool assertionref(Assertion const & assertion);
+};
+
+Disjchecker::Disjchecker(Proofsteps const & steps, Assptr pthm) : m_stride(0)
+{
+    if (!pthm)
+        return;
+    Assertion const & theorem(pthm->second);
+    // Find the variables in the proof.
+    FOR (Proofstep const & step, steps)
+        if (step.type == Proofstep::HYP)
+            FOR (Symbol3 var, step.phyp->second.first)
+                if (var.id)
+                {
+                    if (var.id >= m_local.size())
+                        m_local.resize(var.id + 1);
+                    m_local[var.id] = 1;
+                }
+    // Number them.
+    Proofsize count(0);
+    FOR (Proofsize & id, m_local)
+        if (id)
+            id = ++count;
+    m_stride = (count + wordbits - 1) / wordbits;
+    if (m_stride == 0)
+        m_stride = 1;
+
+    m_used.assign(m_stride, 0);
+    FOR (Varsused::const_reference var, theorem.varsused)
+        if (local(var.first.id) != Proofsize(-1))
+            setbit(&m_used[0], local(var.first.id));
+
+    m_rows.assign(count * m_stride, 0);
+    FOR (Disjvars::const_reference vars, theorem.disjvars)
+    {
+        Proofsize const i(local(vars.first.id)), j(local(vars.second.id));
+        if (i == Proofsize(-1) || j == Proofsize(-1))
+            continue;
+        setbit(&m_rows[i * m_stride], j);
+        setbit(&m_rows[j * m_stride], i);
+    }
+}
+
+// Check the disjoint variable hypotheses of an assertion referenced,
+// with hypotheses on top of the stack.
+// If okay, replace the hypotheses by the conclusion.
+bool Disjchecker::assertionref(Assertion const & assertion)
+{
+    if (m_stride == 0)
+        return true;
+
+    Hypsize const hypcount(assertion.hypcount());
+    std::size_t const base(m_stack.size() / m_stride - hypcount);
+
+    for (Hypsize i(0); i < hypcount; ++i)
+    {
+        Hypothesis const & hyp(assertion.hypiters[i]->second);
+        if (!hyp.second)
+            continue;
+        Symbol2::ID const id(hyp.first[1].id);
+        if (id >= m_hypindex.size())
+            m_hypindex.resize(id + 1);
+        m_hypindex[id] = i;
+    }
+
+    FOR (Disjvars::const_reference vars, assertion.disjvars)
+    {
+        Word const * mask1(stackmask(base + m_hypindex[vars.first.id]));
+        Word const * mask2(stackmask(base + m_hypindex[vars.second.id]));
+        // No common variables
+        for (std::size_t k(0); k < m_stride; ++k)
+            if (mask1[k] & mask2[k])
+                return false;
+        // Used variables must be pairwise disjoint.
+        for (std::size_t k(0); k < m_stride; ++k)
+            for (Word bits(mask1[k] & m_used[k]); bits; bits &= bits - 1)
+            {
+                Proofsize i(k * wordbits);
+                for (Word bit(bits & -bits); bit > 1; bit >>= 1)
+                    ++i;
+                Word const * row(&m_rows[i * m_stride]);
+                for (std::size_t l(0); l < m_stride; ++l)
+                    if (mask2[l] & m_used[l] & ~row[l])
+                        return false;
+            }
+    }
+
+    // Mask of the conclusion
+    Word * const mask(addmask(m_stack));
+    FOR (Symbol3 var, assertion.expression)
+        if (var.id)
+        {
+            Word const * varmask(stackmask(base + m_hypindex[var.id]));
+            for (std::size_t k(0); k < m_stride; ++k)
+                mask[k] |= varmask[k];
+        }
+    // Remove hypotheses from stack.
+    std::copy(m_stack.end() - m_stride, m_stack.end(),
+              m_stack.begin() + base * m_stride);
+    m_stack.resize((base + 1) * m_stride);
+
+    return true;
+}
+
 // Subroutine for proof verification. Verify a proof step referencing an
 // assertion (i.e., not a hypothesis).
 static bool verifyassertionref
     (Assptr pthm, Assptr passref, std::vector<Expression> & stack,
-     Substitutions & substitutions)
+     Substitutions & substitutions, Disjchecker & checker)
 {
     strview thlabel(pthm ? pthm->first : "");
     Assertion const & assertion(passref->second);
@@ -117,12 +267,13 @@ static bool verifyassertionref
 //std::cout << "Substitutions" << std::endl << substitutions;
 
     // Verify disjoint variable conditions.
-    if (pthm)
-        if (!checkdisjvars(pthm->second, assertion.disjvars, substitutions))
-        {
-            std::cerr << "In step " << passref->first;
-            return printinproofof(thlabel);
-        }
+    // The bitmasks are checked. The violation is printed from the sets.
+    if (pthm && !checker.assertionref(assertion))
+    {
+        checkdisjvars(pthm->second, assertion.disjvars, substitutions);
+        util::msgerr() << "In step " << passref->first;
+        return printinproofof(thlabel);
+    }
 
     // Insert new statement onto stack.
     makesubstitution(assertion.expression, stack.back(), substitutions);
@@ -132,6 +283,49 @@ static bool verifyassertionref
     return true;
 }
 
+std::size_t Subproofmemo::Keyhash::operator()(Key const & key) const
+{
+    return util::hash(util::hashbasis, key.data(), key.size() * sizeof(key[0]));
+}
+
+// Return the ID of the subproof of a floating hypothesis,
+// 0 if the hypothesis is essential.
+Subproofmemo::ID Subproofmemo::hyp(Hypptr phyp)
+{
+    if (!phyp->second.second)
+        return 0;
+
+    m_key.assign(1, reinterpret_cast<std::size_t>(phyp));
+    ID & id(m_ids[m_key]);
+    if (id == 0)
+        id = add(phyp->second.first);
+    return id;
+}
+
+// Return pointer to the slot of the subproof applying an assertion to the
+// subproofs with IDs on top of the stack, 0 in the slot if not memoized.
+// Return NULL if the subproof cannot be memoized.
+Subproofmemo::ID * Subproofmemo::find(Assptr pass, std::vector<ID> const & stack)
+{
+    Assertion const & ass(pass->second);
+    Hypsize const hypcount(ass.hypcount());
+    if (!ass.disjvars.empty() || hypcount > stack.size())
+        return NULL;
+
+    m_key.assign(1, reinterpret_cast<std::size_t>(pass));
+    for (Hypsize i(0); i < hypcount; ++i)
+    {
+        if (!ass.hypiters[i]->second.second)
+            return NULL; // Essential hypothesis
+        ID const id(stack[stack.size() - hypcount + i]);
+        if (id == 0)
+            return NULL; // Argument not memoized
+        m_key.push_back(id);
+    }
+
+    return &m_ids[m_key];
+}
+
 // Check if the index of a load step is within the bound.
 static bool enoughsavedsteps
     (Proofstep::Index index, Proofstep::Index savedsteps, strview label)
@@ -142,14 +336,17 @@ static bool enoughsavedsteps
 }
 
 // Subroutine for proof verification. Verify proof steps.
-Expression verifyproofsteps(Proofsteps const & steps,
-                            Printer & printer, Assptr pthm)
+Expression verifyproofsteps(Proofsteps const & steps, Printer & printer,
+                            Assptr pthm, Subproofmemo * memo)
 {
     strview thlabel(pthm ? pthm->first : "");
 //std::cout << "Verifying " << thlabel << std::endl;
     std::vector<Expression> stack, savedsteps;
 
     Substitutions substitutions;
+    Disjchecker checker(steps, pthm);
+    // IDs of items on the stack and saved steps in the memo
+    std::vector<Subproofmemo::ID> ids, savedids;
 
     FOR (Proofstep const & step, steps)
     {
@@ -158,30 +355,59 @@ Expression verifyproofsteps(Proofsteps const & steps,
         case Proofstep::HYP:
 //std::cout << "Pushing hypothesis: " << step.phyp->first << '\n';
             stack.push_back(step.phyp->second.first);
+            checker.pushhyp(stack.back());
+            if (memo)
+                ids.push_back(memo->hyp(step.phyp));
             break;
         case Proofstep::ASS:
 //std::cout << "Applying assertion: " << step.pass->first << '\n';
-            if (!verifyassertionref(pthm, step.pass, stack, substitutions))
+        {
+            // Slot of the subproof in the memo
+            Subproofmemo::ID * const pid(memo ? memo->find(step.pass, ids) : 0);
+            Hypsize const hypcount(step.pass->second.hypcount());
+            if (pid && *pid)
+            {
+                // Found in the memo
+                stack.erase(stack.end() - hypcount, stack.end());
+                stack.push_back(memo->conclusion(*pid));
+                checker.assertionref(step.pass->second);
+            }
+            else if (!verifyassertionref(pthm, step.pass, stack, substitutions,
+                                         checker))
                 return Expression();
+            else if (pid)
+                *pid = memo->add(stack.back());
+            if (memo)
+            {
+                ids.resize(ids.size() - hypcount);
+                ids.push_back(pid ? *pid : 0);
+            }
             break;
+        }
         case Proofstep::LOAD:
 //std::cout << "Loading saved step " << step.index << std::endl;
             if (!enoughsavedsteps(step.index, savedsteps.size(), thlabel))
                 return Expression();
             stack.push_back(savedsteps[step.index]);
+            checker.load(step.index);
+            if (memo)
+                ids.push_back(savedids[step.index]);
             break;
         case Proofstep::SAVE:
 //std::cout << "Saving step " << savedsteps.size() << std::endl;
             if (stack.empty())
             {
-                std::cerr << "No step to save";
+                util::msgerr() << "No step to save";
                 printinproofof(thlabel);
                 return Expression();
             }
             savedsteps.push_back(stack.back());
+            checker.save();
+            if (memo)
+                savedids.push_back(ids.back());
             break;
         default:
-            std::cerr << "Invalid step";
+            util::msgerr() << "Invalid step";
             printinproofof(thlabel);
             return Expression();
         }
@@ -191,7 +417,8 @@ Expression verifyproofsteps(Proofsteps const & steps,
 
     if (stack.size() != 1)
     {
-        std::cerr << "Proof of theorem " << thlabel << stackszerr << std::endl;
+        util::msgerr() << "Proof of theorem " << thlabel << stackszerr
+                       << std::endl;
         return Expression();
     }
 
@@ -212,7 +439,7 @@ Expression verifyregularproof
     Proofsteps steps(regularproofsteps(proof, hypotheses, assertions));
     if (steps.empty())
     {
-        std::cout << " in regular proof of " << label << std::endl;
+        util::msgout() << " in regular proof of " << label << std::endl;
         return Expression();
     }
 
@@ -226,7 +453,8 @@ bool provesrightthing
     if (conclusion == expression)
         return true;
 
-    std::cerr << "Proof of theorem " << label << " proves wrong statement:\n"
-              << conclusion << "instead of:\n" << expression;
+    util::msgerr() << "Proof of theorem " << label
+                   << " proves wrong statement:\n"
+                   << conclusion << "instead of:\n" << expression;
     return false;
 }
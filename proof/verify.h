@@ -2,13 +2,11 @@
 #define VERIFY_H_INCLUDED
 
 #include <algorithm>
+#include <unordered_map>
 #include "printer.h"
 #include "step.h"
 #include "../util/for.h"
 
-// Extract proof steps from a compressed proof.
-Proofsteps compressedproofsteps
-    (Proofsteps const & labels, Proofnumbers const & proofnumbers);
 // Extract proof steps from a regular proof.
 Proofsteps regularproofsteps
     (Proof const & proof,
@@ -109,13 +107,53 @@ typename std::vector<EXP>::size_type findsubstitutions
     return base;
 }
 
+// Memo of syntax subproofs, built from floating hypotheses and assertions
+// with only floating hypotheses and no disjoint variable hypotheses.
+// Their conclusions do not depend on the theorem being proved.
+class Subproofmemo
+{
+public:
+    // ID of a memoized subproof, 0 if not memoized
+    typedef std::size_t ID;
+private:
+    // Key: (pointer to hypothesis or assertion, IDs of arguments...)
+    typedef std::vector<std::size_t> Key;
+    struct Keyhash
+    {
+        std::size_t operator()(Key const & key) const;
+    };
+    std::unordered_map<Key, ID, Keyhash> m_ids;
+    // Conclusions of memoized subproofs, indexed by ID - 1
+    std::vector<Expression> m_conclusions;
+    Key m_key;
+public:
+    // Return the ID of the subproof of a floating hypothesis,
+    // 0 if the hypothesis is essential.
+    ID hyp(Hypptr phyp);
+    // Return pointer to the slot of the subproof applying an assertion to the
+    // subproofs with IDs on top of the stack, 0 in the slot if not memoized.
+    // Return NULL if the subproof cannot be memoized.
+    ID * find(Assptr pass, std::vector<ID> const & stack);
+    // Memoize the conclusion of a subproof. Return its ID.
+    ID add(Expression const & conclusion)
+    {
+        m_conclusions.push_back(conclusion);
+        return m_conclusions.size();
+    }
+    Expression const & conclusion(ID id) const { return m_conclusions[id-1]; }
+    // # subproofs memoized
+    std::size_t size() const { return m_conclusions.size(); }
+};
+
 // Subroutine for proof verification. Verify proof steps.
-Expression verifyproofsteps(Proofsteps const & steps,
-                            Printer & printer, Assptr pthm = 0);
-inline Expression verifyproofsteps(Proofsteps const & steps, Assptr pthm = 0)
+// Syntax subproofs are looked up in the memo, if there is one.
+Expression verifyproofsteps(Proofsteps const & steps, Printer & printer,
+                            Assptr pthm = 0, Subproofmemo * memo = 0);
+inline Expression verifyproofsteps(Proofsteps const & steps, Assptr pthm = 0,
+                                   Subproofmemo * memo = 0)
 {
     Printer printer;
-    return verifyproofsteps(steps, printer, pthm);
+    return verifyproofsteps(steps, printer, pthm, memo);
 }
 // Verify a regular proof. The "proof" argument should be a non-empty sequence
 // of valid labels. Return the statement the "proof" proves.
@@ -180,7 +180,7 @@ int Propctors::calctruthvalue
 
     if (stack.size() != 1)
     {
-        std::cerr << "Syntax proof " << rhs << stackszerr << std::endl;
+        util::msgerr() << "Syntax proof " << rhs << stackszerr << std::endl;
         return -1;
     }
 
@@ -190,12 +190,9 @@ int Propctors::calctruthvalue
 // Add lit <-> atom (in the positive sense) to CNF.
 static void addlitatomequiv(CNFClauses & cnf, Literal lit, Atom atom)
 {
-    CNFClauses::size_type const n(cnf.size());
-    cnf.resize(n + 2);
 //std::cout << "Single literal CNF (" << lit << '<->' << atom << ") added\n";
-    cnf[n].resize(2),           cnf[n + 1].resize(2);
-    cnf[n][0] = lit,            cnf[n][1] = 2 * atom + 1;
-    cnf[n + 1][0] = lit ^ 1,    cnf[n + 1][1] = 2 * atom;
+    cnf.newclause(), cnf.addliteral(lit), cnf.addliteral(2 * atom + 1);
+    cnf.newclause(), cnf.addliteral(lit ^ 1), cnf.addliteral(2 * atom);
 //std::cout << cnf;
 }
 
@@ -206,9 +203,10 @@ bool Propctors::addclause
     (Proofsteps const & formula, Hypiters const & hyps,
      CNFClauses & cnf, Atom & natom) const
 {
-    Prooftree const & tree(prooftree(formula));
-    if (unexpected(tree.empty(), "corrupt proof tree when adding CNF from",
-                   formula))
+    // Proof tree of the formula, reusing the space
+    thread_local static Prooftree tree;
+    if (unexpected(!tree.assign(formula),
+                   "corrupt proof tree when adding CNF from", formula))
         return false;
 
     std::vector<Literal> literals(formula.size());
@@ -230,7 +228,7 @@ bool Propctors::addclause
 //std::cout << "New CNF:\n" << cnf;
                 return true;
             }
-            std::cerr << "In " << formula;
+            util::msgerr() << "In " << formula;
             return !unexpected(true, "hypothesis", step);
         }
 //std::cout << "operator ";
@@ -304,6 +302,115 @@ bool Propctors::checkpropsat
         return true;
 
     if (&conclusion == &ass.exprPolish)
-        std::cerr << "CNF:\n" << clauses << "counter-satisfiable" << std::endl;
+        util::msgerr() << "CNF:\n" << clauses << "counter-satisfiable"
+                       << std::endl;
     return false;
 }
+
+// Evaluate the truth table on words of arguments.
+static Propctors::Truthword evaltruthtableonwords
+    (Bvector const & truthtable, Propctors::Truthword const * args)
+{
+    Atom const argcount(util::log2(truthtable.size()));
+    Propctors::Truthword result(0);
+    for (Bvector::size_type arg(0); arg < truthtable.size(); ++arg)
+    {
+        if (!truthtable[arg])
+            continue;
+        // Assignments where the arguments are packed into arg
+        Propctors::Truthword term(~Propctors::Truthword(0));
+        for (Atom i(0); i < argcount; ++i)
+            term &= arg >> i & 1 ? args[i] : ~args[i];
+        result |= term;
+    }
+    return result;
+}
+
+// Evaluate a formula, given the truth values of the hypotheses.
+// Return true if okay.
+bool Propctors::evaltruthwords
+    (Proofsteps const & formula, Hypiters const & hyps,
+     std::vector<Truthword> const & hypwords, Truthword & result) const
+{
+    std::vector<Truthword> stack;
+    FOR (Proofstep const & formulastep, formula)
+    {
+        const char * step(formulastep);
+        if (formulastep.type == Proofstep::HYP)
+        {
+            Hypsize const hypindex(util::find(hyps, step) - hyps.begin());
+            if (hypindex == hyps.size())
+                return false;
+            stack.push_back(hypwords[hypindex]);
+            continue;
+        }
+        const_iterator const iter(find(step));
+        if (iter == end() || iter->second.argcount > stack.size())
+            return false;
+        Truthword const value(evaltruthtableonwords
+            (iter->second.truthtable, &stack[stack.size() - iter->second.argcount]));
+        stack.resize(stack.size() - iter->second.argcount);
+        stack.push_back(value);
+    }
+
+    if (stack.size() != 1)
+        return false;
+    result = stack[0];
+    return true;
+}
+
+// Check if an expression is valid given a propositional assertion,
+// by evaluating the truth tables on all assignments to the variables.
+// Return 1 if valid, 0 if not, -1 if not okay or more than maxvars variables.
+int Propctors::checkproptruth
+    (struct Assertion const & ass, Proofsteps const & conclusion,
+     Atom maxvars) const
+{
+    Hypiters const & hyps(ass.hypiters);
+    // Variables are the floating hypotheses, numbered by position.
+    std::vector<Atom> varindex(hyps.size());
+    Atom nvar(0);
+    for (Hypsize i(0); i < hyps.size(); ++i)
+        if (hyps[i]->second.second)
+            varindex[i] = nvar++;
+    if (nvar > maxvars)
+        return -1;
+
+    // # variables assigned within a word
+    Atom const wordbits(std::numeric_limits<Truthword>::digits);
+    Atom const wordvars(util::log2(wordbits));
+    // Truth values of the hypotheses. Bit k of a word is bit var of k.
+    std::vector<Truthword> hypwords(hyps.size());
+    for (Hypsize i(0); i < hyps.size(); ++i)
+        if (hyps[i]->second.second && varindex[i] < wordvars)
+            for (Atom k(0); k < wordbits; ++k)
+                hypwords[i] |= Truthword(k >> varindex[i] & 1) << k;
+    // The other variables are constant within each word.
+    Bvector::size_type const nword
+        (nvar > wordvars ? Bvector::size_type(1) << (nvar - wordvars) : 1);
+    for (Bvector::size_type word(0); word < nword; ++word)
+    {
+        for (Hypsize i(0); i < hyps.size(); ++i)
+            if (hyps[i]->second.second && varindex[i] >= wordvars)
+                hypwords[i] = word >> (varindex[i] - wordvars) & 1 ?
+                    ~Truthword(0) : 0;
+        // Assignments satisfying all the essential hypotheses
+        Truthword hypsvalue(~Truthword(0));
+        for (Hypsize i(0); i < hyps.size(); ++i)
+        {
+            if (hyps[i]->second.second)
+                continue;
+            Truthword value;
+            if (!evaltruthwords(ass.hypsrPolish[i], hyps, hypwords, value))
+                return -1;
+            hypsvalue &= value;
+        }
+        Truthword value;
+        if (!evaltruthwords(conclusion, hyps, hypwords, value))
+            return -1;
+        if (hypsvalue & ~value)
+            return 0;
+    }
+
+    return 1;
+}
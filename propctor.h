@@ -25,6 +25,8 @@ bool checkpropctor(Propctor const & propctor);
 // Map: propositional syntax constructor label -> data
 struct Propctors : public std::map<strview, Propctor>
 {
+// Truth values of a formula on 64 assignments, one bit for each
+    typedef unsigned long long Truthword;
     Propctors(Definitions const & definitions = Definitions());
 // Check if data for all propositional syntax constructor are okay.
     bool okay(Definitions const & definitions = Definitions()) const;
@@ -44,12 +46,23 @@ struct Propctors : public std::map<strview, Propctor>
 // Check if an expression is valid given a propositional assertion.
     bool checkpropsat
         (struct Assertion const & ass, Proofsteps const & conclusion) const;
+// Check if an expression is valid given a propositional assertion,
+// by evaluating the truth tables on all assignments to the variables.
+// Return 1 if valid, 0 if not, -1 if not okay or more than maxvars variables.
+    int checkproptruth
+        (struct Assertion const & ass, Proofsteps const & conclusion,
+         Atom maxvars) const;
 private:
 // Initialize with basic propositional connectives.
     void init();
 // Add a definition. Return the iterator to the entry. Otherwise return end.
     Propctors::const_iterator adddef
         (Definitions const & definitions, Definitions::const_reference labeldef);
+// Evaluate a formula, given the truth values of the hypotheses.
+// Return true if okay.
+    bool evaltruthwords
+        (Proofsteps const & formula, Hypiters const & hyps,
+         std::vector<Truthword> const & hypwords, Truthword & result) const;
 // Evaluate *iter at arg. Return -1 if not okay.
     int calctruthvalue
         (Definitions const & definitions, Proofsteps const & lhs,
@@ -2,8 +2,11 @@
 #include "util/filter.h"
 #include "getproof.h"
 #include "io.h"
+#include "util/mute.h"
+#include "pipeline.h"
 #include "util/progress.h"
 #include "scope.h"
+#include "proof/cache.h"
 #include "proof/verify.h"
 
 namespace {
@@ -13,10 +16,19 @@ class Imp
     Database & m_database;
     Scopes m_scopes;
     Tokens & m_tokens;
+    Verifycache * m_cache;
+    // Source of more tokens, if they are read on the fly
+    Tokenfeed * m_feed;
+    // Verifier of proofs on other threads, if any
+    Verifypool * m_pool;
+    // Memo of syntax subproofs, if any
+    Subproofmemo * m_memo;
 public:
-    Imp(Database & database, Tokens & tokens, Comments const & comments) :
-        m_comments(comments), m_database(database), m_scopes(), m_tokens(tokens)
-        {}
+    Imp(Database & database, Tokens & tokens, Comments const & comments,
+        Verifycache * cache, Subproofmemo * memo,
+        Tokenfeed * feed = NULL, Verifypool * pool = NULL) :
+        m_comments(comments), m_database(database), m_scopes(), m_tokens(tokens),
+        m_cache(cache), m_feed(feed), m_pool(pool), m_memo(memo) {}
 private:
 // Read rest of expression after its type.
 // Discard tokens up to and including the terminator.
@@ -238,20 +250,9 @@ int Imp::readcompressedproof
         return 0;
 //std::cout << labels.size() << " hypotheses and labels" << std::endl;
 
-    // Get proof letters
-    std::string proof;
-    int const okay(getproofletters(label, m_tokens, proof));
-    if (okay != 1)  // Bad or incomplete proof
-        return okay;
-
-    // Get proof numbers
-    Proofnumbers const & proofnumbers(getproofnumbers(label, proof));
-    if (proofnumbers.empty())
-        return 0;
-
     // Get proof steps
-    steps = compressedproofsteps(labels, proofnumbers);
-    return 1;
+    steps.clear();
+    return getproofsteps(label, m_tokens, labels, steps);
 }
 
 // Read a regular proof. Discard tokens up to and including $.
@@ -306,8 +307,7 @@ bool Imp::addfloatinghyp(strview label, strview type, strview var)
     Expression exp(2);
     exp[0] = type, exp[1] = Symbol3(var, m_database.varid(var));
     Hypiter const iter(m_database.addhyp(label, exp, true));
-    m_scopes.back().activehyp.push_back(iter);
-    m_scopes.back().floatinghyp[var] = iter;
+    m_scopes.addhyp(iter);
     m_database.addtypecode(type);
 
     return true;
@@ -320,7 +320,7 @@ bool Imp::reade(strview label)
     if (exp.empty())
         return false;
     // Create new essential hypothesis
-    m_scopes.back().activehyp.push_back(m_database.addhyp(label, exp, false));
+    m_scopes.addhyp(m_database.addhyp(label, exp, false));
     return true;
 }
 
@@ -331,7 +331,10 @@ bool Imp::reada(strview label)
     if (exp.empty())
         return false;
     // Add axiom to database
-    addasstype(m_database.addass(label, exp, m_scopes, m_tokens.position)->second, true);
+    Assertions::iterator iter(m_database.addass(label, exp, m_scopes, m_tokens.position));
+    addasstype(iter->second, true);
+    if (m_cache)
+        iter->second.hash = statementhash(*iter);
     return true;
 }
 
@@ -348,6 +351,10 @@ bool Imp::readp(strview label)
     // Classify assertion
     Assertion & ass(iter->second);
     addasstype(ass, false);
+    // Hash the statement even if the proof is incomplete,
+    // since proofs using the theorem depend on it.
+    if (m_cache)
+        ass.hash = statementhash(*iter);
 
     // Now for the proof
     if (unfinishedstat(m_tokens, "$p", label))
@@ -359,11 +366,32 @@ bool Imp::readp(strview label)
     if (okay != 1) // Incomplete: -1 -> true, bad: 0 -> false
         return okay == -1;
 
+    // Skip proofs verified in an earlier run
+    util::Hash hash(0);
+    if (m_cache)
+    {
+        hash = proofhash(ass.hash, steps);
+        if (m_cache->hit(label, hash))
+        {
+            ass.proofsteps.swap(steps);
+            return true;
+        }
+    }
+
+    // Leave it to the verifier threads
+    // Stop reading if an earlier proof is bad.
+    if (m_pool)
+        return m_pool->add(iter, steps, hash);
+
     // Verify proof steps
-    Expression const & exp(verifyproofsteps(steps, &*iter));
+    Expression const & exp(verifyproofsteps(steps, &*iter, m_memo));
     okay = provesrightthing(label, exp, ass.expression);
     if (okay)
-        ass.proofsteps = steps;
+    {
+        ass.proofsteps.swap(steps);
+        if (m_cache)
+            m_cache->add(label, hash);
+    }
 
     return okay;
 }
@@ -609,7 +637,7 @@ bool Imp::readv()
             return false;
         }
         m_database.addvar(token);
-        m_scopes.back().activevariables.insert(token);
+        m_scopes.addvariable(token);
     }
 
     if (unfinishedstat(m_tokens, "$v", ""))
@@ -626,7 +654,7 @@ bool Imp::readv()
 // Read tokens. Returns true iff okay.
 bool Imp::read(Tokens::size_type const upto)
 {
-    Progress progress;
+    Progress progress(util::msgout());
 
     // Global scope
     m_scopes.push_back(Scope());
@@ -634,6 +662,10 @@ bool Imp::read(Tokens::size_type const upto)
     // Read the tokens.
     while (m_tokens.position < upto)
     {
+        // Tokens read on the fly end at statement boundaries.
+        if (m_tokens.empty() && !(m_feed && m_feed->refill()))
+            break;
+
         strview token(m_tokens.front());
         m_tokens.pop();
 
@@ -672,25 +704,57 @@ bool Imp::read(Tokens::size_type const upto)
             return false;
         progress << m_tokens.position / static_cast<double>(upto);
     }
+    if (m_feed)
+        progress << 1;
 
     return m_scopes.isouter("${ without corresponding $}");
 }
 } // anonymous namespace
 
 // Read data from tokens. Returns true iff okay.
+// Proofs found in the cache are not verified again.
+// If memo is true, syntax subproofs are memoized across theorems.
 bool Database::read(Tokens & tokens, Comments const & comments,
-                    Tokens::size_type upto)
+                    Tokens::size_type upto, Verifycache * cache, bool memo)
 {
     clear();
 
-    // Comment info
-    Commands const commands(comments["$j"]);
+    loadcommentinfo(comments);
+
+    Subproofmemo subproofmemo;
+    Imp imp(*this, tokens, comments, cache, memo ? &subproofmemo : NULL);
+    return imp.read(upto);
+}
+
+// Read data from tokens fed on the fly, verifying proofs on other threads.
+// Returns true iff okay.
+// If memo is true, syntax subproofs are memoized across theorems.
+bool Database::read(Tokenfeed & feed, Verifycache * cache, bool memo)
+{
+    clear();
+
+    Verifypool pool(0, memo);
+    Imp imp(*this, feed.tokens(), feed.comments(), cache, NULL, &feed, &pool);
+    bool const okay(imp.read(static_cast<Tokens::size_type>(-1)));
+    if (!(pool.finish(cache) && okay))
+        return false;
+
+    // $j comments are only known now. Keep type codes from $f statements.
+    Typecodes const typecodes(m_commentinfo.typecodes);
+    loadcommentinfo(feed.comments());
+    m_commentinfo.typecodes.insert(typecodes.begin(), typecodes.end());
+
+    return true;
+}
+
+// Load comment info from $j comments.
+void Database::loadcommentinfo(Comments const & comments)
+{
+    Commands const commands(comments.commands("$j"));
 //std::cout << "$j commands\n" << commands;
     m_commentinfo.typecodes = Typecodes(commands["syntax"], commands["bound"]);
 //std::cout << "Syntax type codes: " << typecodes;
 //std::cout << "Bound type codes: " << commands["bound"];
     m_commentinfo.ctordefns = Ctordefns(commands["definition"], commands["primitive"]);
 //std::cout << "Constructor definitions: " << ctordefns;
-
-    return Imp(*this, tokens, comments).read(upto);
 }
@@ -5,9 +5,11 @@
 #include <locale>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include "comment.h"
 #include "msg.h"
+#include "pipeline.h"
 #include "token.h"
 #include "util/find.h"
 #include "util/for.h"
@@ -100,9 +102,10 @@ static bool openfile(std::ifstream & in, std::string const & name)
 }
 
 // Read tokens. Returns true iff okay.
+template<class TOKENS, class COMMENTS>
 static bool readtokens
     (const char * const filename, std::set<std::string> & names,
-     Tokens & tokens, Comments & comments)
+     TOKENS & tokens, COMMENTS & comments)
 {
     bool const alreadyencountered(!names.insert(filename).second);
     if (alreadyencountered)
@@ -127,7 +130,7 @@ static bool readtokens
         {
             // Read and return a comment. Return "" on failure ($4.1.2).
             std::string comment(std::ifstream & in);
-            Comment const newcomment = {comment(in), tokens.size()};
+            Comment const newcomment(comment(in), tokens.size());
             if (newcomment.text.empty())
             {
                 std::cerr << "Bad comment" << std::endl;
@@ -211,3 +214,50 @@ bool read(const char * const filename,
     std::set<std::string> names;
     return readtokens(filename, names, tokens, comments);
 }
+
+// Collects tokens and comments into batches and sends them to a queue
+class Batcher
+{
+    Tokenqueue & m_queue;
+    Tokenbatch m_batch;
+    // # tokens read so far
+    Tokens::size_type m_size;
+public:
+    // Minimal # tokens in a batch
+    static const std::size_t batchsize = 1 << 12;
+    Batcher(Tokenqueue & queue) : m_queue(queue), m_size(0) {}
+    Tokens::size_type size() const { return m_size; }
+    void push_back(Token const & token)
+    {
+        m_batch.tokens.push_back(token);
+        ++m_size;
+        // Only break between statements.
+        if (m_batch.tokens.size() >= batchsize &&
+            (token == "$." || token == "${" || token == "$}"))
+            flush();
+    }
+    void push_back(Comment const & comment)
+    {
+        m_batch.comments.push_back(comment);
+    }
+    // Send the current batch.
+    void flush()
+    {
+        if (m_batch.tokens.empty() && m_batch.comments.empty())
+            return;
+        m_queue.push(std::move(m_batch));
+        m_batch = Tokenbatch();
+    }
+};
+
+// Read tokens in batches into the queue, and close the queue.
+// Returns true iff okay.
+bool read(const char * const filename, Tokenqueue & queue)
+{
+    std::set<std::string> names;
+    Batcher batcher(queue);
+    bool const okay(readtokens(filename, names, batcher, batcher));
+    batcher.flush();
+    queue.close();
+    return okay;
+}
@@ -1,36 +1,140 @@
+#include <chrono>
+#include <iostream>
 #include <limits>
 #include "io.h"
 #include "msg.h"
 
+#include "satsolve/CDCL.h"
 #include "satsolve/DPLL.h"
-typedef DPLL_solver Solver_used;
+#include "satsolve/truthtbl.h"
+#include "satsolve/watchlst.h"
+
+std::ostream & operator<<(std::ostream & out, Satstats const & stats)
+{
+    out << stats.calls << " SAT calls, " << stats.clauses << " clauses, ";
+    out << stats.atoms << " atoms, " << stats.decisions << " decisions, ";
+    out << stats.propagations << " propagations, ";
+    return out << stats.nanoseconds * 1e-9 << 's' << std::endl;
+}
+
+// Statistics of all SAT calls since the last clear
+Satstats & satstats()
+{
+    static Satstats stats;
+    return stats;
+}
+
+static Satsolvers makesatsolvers()
+{
+    Satsolvers solvers;
+    solvers["reference"] = solvesat<Satsolver>;
+    solvers["dpll"] = solvesat<DPLL_solver>;
+    solvers["watchlist"] = solvesat<Watchlist_solver>;
+    solvers["cdcl"] = solvesat<CDCL_solver>;
+    solvers["truthtable"] = solvesat<Truthtable_solver>;
+    return solvers;
+}
+
+// All the SAT solvers available
+Satsolvers const & satsolvers()
+{
+    static Satsolvers const solvers(makesatsolvers());
+    return solvers;
+}
+
+// Solver used by CNFClauses::sat
+static Satfunction satsolver(solvesat<DPLL_solver>);
+
+// Set the solver used by CNFClauses::sat, DPLL by default.
+// Return the old one. Call before starting other threads.
+Satfunction setsatsolver(Satfunction solver)
+{
+    std::swap(solver, satsolver);
+    return solver;
+}
+
+// Set the solver used by CNFClauses::sat by name.
+// Return false if there is no such solver.
+bool setsatsolver(std::string const & name)
+{
+    Satsolvers::const_iterator const iter(satsolvers().find(name));
+    if (iter == satsolvers().end())
+        return false;
+    setsatsolver(iter->second);
+    return true;
+}
 
 // Return true if the SAT instance is satisfiable.
 bool CNFClauses::sat() const
 {
-    return empty() || Solver_used(*this).sat();
+    if (empty())
+        return true;
+
+    Satstats & stats(satstats());
+    if (!stats.enabled)
+        return satsolver(*this);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point const start(Clock::now());
+    bool const result(satsolver(*this));
+    ++stats.calls;
+    stats.clauses += size();
+    stats.atoms += atomcount();
+    stats.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>
+        (Clock::now() - start).count();
+    return result;
 }
 
 // Map: free atoms -> truth value.
+// Rows undecided by unit propagation are solved by fallback,
+// or CNFClauses::sat if it is NULL.
 // Return the empty vector if not okay.
-Bvector Satsolver::truthtable(Atom const nfree)
+Bvector Satsolver::truthtable(Atom const nfree, Satfunction fallback)
 {
     static Atom const maxnfree(std::numeric_limits<Atom>::digits);
     if (!is1stle2nd(nfree, std::min(maxnfree, rcnf.atomcount()),
                     varfound, varallowed))
         return Bvector();
 
-    Bvector truthtable(1u << nfree, false);
+    Bvector truthtable(Bvector::size_type(1) << nfree, false);
     if (rcnf.hasemptyclause())
         return truthtable;
 
-    CNFClauses cnf2(rcnf);
-    for (Bvector::size_type arg(0); arg < (1u << nfree); ++arg)
+    // Rows are evaluated 64 at a time, one for each model.
+    // The first free atoms are enumerated within the models.
+    Atom const rowbits(CNFModels::modelcount);
+    CNFModels::Word const rows(nfree < CNFModels::wordatoms ?
+        (CNFModels::Word(1) << (1u << nfree)) - 1 : ~CNFModels::Word(0));
+    CNFClauses cnf2;
+    for (Bvector::size_type row0(0); row0 < truthtable.size(); row0 += rowbits)
     {
+        CNFModels models(rcnf.atomcount());
         for (Atom i(0); i < nfree; ++i)
-            cnf2.push_back(CNFClause(1, i * 2 + 1 - (arg >> i & 1)));
-        truthtable[arg] = cnf2.sat();
-        cnf2.resize(rcnf.size());
+        {
+            if (i < CNFModels::wordatoms)
+                models.enumerate(i, i);
+            else
+                models.assign(i * 2 + 1 - (row0 >> i & 1), ~CNFModels::Word(0));
+        }
+        // Propagate unit clauses over the auxiliary atoms.
+        CNFModels::Word active(rows);
+        CNFModels::Word const sat(rcnf.unitprop(models, active));
+        for (Atom k(0); k < rowbits && row0 + k < truthtable.size(); ++k)
+        {
+            if (sat >> k & 1)
+                truthtable[row0 + k] = true;
+            else if (active >> k & 1)
+            {
+                // Undecided by unit propagation. Call the solver.
+                if (cnf2.empty())
+                    cnf2 = rcnf;
+                Bvector::size_type const arg(row0 + k);
+                for (Atom i(0); i < nfree; ++i)
+                    cnf2.closeoff(i * 2 + 1 - (arg >> i & 1));
+                truthtable[arg] = fallback ? fallback(cnf2) : cnf2.sat();
+                cnf2.truncate(rcnf.size());
+            }
+        }
     }
 
     return truthtable;
@@ -40,5 +144,5 @@ Bvector Satsolver::truthtable(Atom const nfree)
 // Return the empty vector if not okay.
 Bvector CNFClauses::truthtable(Atom const nfree) const
 {
-    return Solver_used(*this).truthtable(nfree);
+    return Satsolver(*this).truthtable(nfree);
 }
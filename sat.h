@@ -1,20 +1,32 @@
 #ifndef SAT_H_INCLUDED
 #define SAT_H_INCLUDED
 
+#include <atomic>
+#include <iosfwd>
+#include <map>
+#include <string>
 #include "cnf.h"
 
+// Function solving an SAT instance. Return true if it is satisfiable.
+typedef bool (*Satfunction)(CNFClauses const & cnf);
+
 class Satsolver
 {
 public:
 // Associated SAT instance
     CNFClauses const & rcnf;
+// # decisions and propagations made
+    std::size_t decisions, propagations;
 // Initialize the solver with an SAT instance.
-    Satsolver(CNFClauses const & cnf) : rcnf(cnf) {}
+    Satsolver(CNFClauses const & cnf) :
+        rcnf(cnf), decisions(0), propagations(0) {}
 // Return true if the SAT instance is satisfiable.
     bool sat() { return backtrack_sat(&checkmodel); }
 // Map: free atoms -> truth value.
+// Rows undecided by unit propagation are solved by fallback,
+// or CNFClauses::sat if it is NULL.
 // Return the empty vector if not okay.
-    Bvector truthtable(Atom const nfree);
+    Bvector truthtable(Atom const nfree, Satfunction fallback = NULL);
 protected:
 // Reference backtracking solver
     template<class T> bool backtrack_sat(T checkmodel);
@@ -24,6 +36,53 @@ private:
     { return cnf.okaysofar(model); }
 };
 
+// Statistics of SAT calls, safe to update from many threads
+struct Satstats
+{
+    // Are the statistics collected? Set before starting other threads.
+    bool enabled;
+    std::atomic<std::size_t> calls, clauses, atoms, decisions, propagations;
+    // Time spent, in nanoseconds
+    std::atomic<std::size_t> nanoseconds;
+    Satstats() : enabled(false) { clear(); }
+    void clear()
+    {
+        calls = clauses = atoms = 0;
+        decisions = propagations = nanoseconds = 0;
+    }
+};
+
+std::ostream & operator<<(std::ostream & out, Satstats const & stats);
+
+// Statistics of all SAT calls since the last clear
+Satstats & satstats();
+
+// Solve cnf with a solver class, and add its counts to the statistics.
+template<class Solver> bool solvesat(CNFClauses const & cnf)
+{
+    Solver solver(cnf);
+    bool const result(solver.sat());
+    Satstats & stats(satstats());
+    if (stats.enabled)
+    {
+        stats.decisions += solver.decisions;
+        stats.propagations += solver.propagations;
+    }
+    return result;
+}
+
+// Map: name -> SAT solver
+typedef std::map<std::string, Satfunction> Satsolvers;
+// All the SAT solvers available
+Satsolvers const & satsolvers();
+
+// Set the solver used by CNFClauses::sat, DPLL by default.
+// Return the old one. Call before starting other threads.
+Satfunction setsatsolver(Satfunction solver);
+// Set the solver used by CNFClauses::sat by name.
+// Return false if there is no such solver.
+bool setsatsolver(std::string const & name);
+
 template<class T>
 bool Satsolver::backtrack_sat(T checkmodel)
 {
@@ -39,6 +98,7 @@ bool Satsolver::backtrack_sat(T checkmodel)
 //std::cout << "Trying atom " << atom << " = " << model[atom] << '\n';
         case CNFNONE : case CNFFALSE :
             ++model[atom];
+            ++decisions;
             // Check if there is a contradiction so far.
             if (checkmodel(rcnf, model, atom))
             {
@@ -49,6 +109,13 @@ bool Satsolver::backtrack_sat(T checkmodel)
                     //std::cout << model;
                     return true;
                 }
+                // Try all values of the remaining atoms at once.
+                if (model.size() - atom <= CNFModels::wordatoms)
+                {
+                    if (rcnf.okaysofar(CNFModels(model)))
+                        return true;
+                    --atom;
+                }
             }
             // Move to next model.
             continue;
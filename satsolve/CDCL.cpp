@@ -0,0 +1,332 @@
+#include <algorithm>
+#include "CDCL.h"
+
+CDCL_solver::size_type const CDCL_solver::NOCLAUSE;
+
+// Return the i-th term of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+static std::size_t luby(std::size_t i)
+{
+    // Find the finite subsequence containing i, and its size.
+    std::size_t size(1), power(1);
+    while (size < i + 1)
+        size = 2 * size + 1, power *= 2;
+    while (size - 1 != i)
+    {
+        size = (size - 1) / 2;
+        power /= 2;
+        i %= size;
+    }
+    return power;
+}
+
+// Add a clause. Return false if it is empty.
+bool CDCL_solver::addclause(CNFClauseview const & clause)
+{
+    CNFClause & lits(m_clause);
+    lits.assign(clause.begin(), clause.end());
+    std::sort(lits.begin(), lits.end());
+    lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+    // Drop literals false at level 0.
+    CNFClause::size_type n(0);
+    for (CNFClause::size_type i(0); i < lits.size(); ++i)
+    {
+        if (value(lits[i]) == CNFTRUE ||
+            (i > 0 && lits[i] == (lits[i - 1] ^ 1)))
+            return true; // Satisfied or tautology
+        if (value(lits[i]) == CNFNONE)
+            lits[n++] = lits[i];
+    }
+    lits.resize(n);
+
+    if (lits.empty())
+        return false;
+    if (lits.size() == 1)
+    {
+        assign(lits[0], NOCLAUSE);
+        return true;
+    }
+    // Watch the first 2 literals.
+    size_type const c(m_begins.size() - 1);
+    m_literals.insert(m_literals.end(), lits.begin(), lits.end());
+    m_begins.push_back(m_literals.size());
+    m_watches[lits[0]].push_back(c);
+    m_watches[lits[1]].push_back(c);
+    return true;
+}
+
+// Make a literal true, for a reason clause.
+void CDCL_solver::assign(Literal lit, size_type reason)
+{
+    m_values[lit / 2] = 1 - lit % 2;
+    m_levels[lit / 2] = level();
+    m_reasons[lit / 2] = reason;
+    m_trail.push_back(lit);
+}
+
+// Propagate the trail. Return the conflicting clause, or NOCLAUSE.
+CDCL_solver::size_type CDCL_solver::propagate()
+{
+    while (m_next < m_trail.size())
+    {
+        Literal const falselit(m_trail[m_next++] ^ 1);
+        ++propagations;
+        std::vector<size_type> & watches(m_watches[falselit]);
+        // Clauses still watching the false literal are moved to [0, j).
+        size_type j(0);
+        for (size_type i(0); i < watches.size(); ++i)
+        {
+            size_type const c(watches[i]);
+            Literal * const lits(&m_literals[m_begins[c]]);
+            size_type const size(m_begins[c + 1] - m_begins[c]);
+            // Make the false literal the second one.
+            if (lits[0] == falselit)
+                std::swap(lits[0], lits[1]);
+            if (value(lits[0]) == CNFTRUE)
+            {
+                watches[j++] = c;
+                continue;
+            }
+            // Look for a new literal to watch.
+            size_type k(2);
+            while (k < size && value(lits[k]) == CNFFALSE)
+                ++k;
+            if (k < size)
+            {
+                std::swap(lits[1], lits[k]);
+                m_watches[lits[1]].push_back(c);
+                continue;
+            }
+            // The clause is unit or conflicting.
+            watches[j++] = c;
+            if (value(lits[0]) == CNFFALSE)
+            {
+                while (++i < watches.size())
+                    watches[j++] = watches[i];
+                watches.resize(j);
+                return c;
+            }
+            assign(lits[0], c);
+        }
+        watches.resize(j);
+    }
+
+    return NOCLAUSE;
+}
+
+// Learn a clause from a conflict. Return the level to jump back to.
+// The first literal of the clause is the negation of the 1-UIP.
+CDCL_solver::size_type CDCL_solver::analyze
+    (size_type clause, CNFClause & learnt)
+{
+    learnt.assign(1, 0);
+    // # atoms at the current level still to resolve
+    size_type pending(0);
+    // Literal resolved on
+    Literal lit(0);
+    size_type index(m_trail.size());
+    do
+    {
+        // Skip the literal implied by a reason clause, which comes first.
+        size_type const begin(m_begins[clause] + (index < m_trail.size()));
+        for (size_type i(begin); i < m_begins[clause + 1]; ++i)
+        {
+            Atom const atom(m_literals[i] / 2);
+            if (m_seen[atom] || m_levels[atom] == 0)
+                continue;
+            m_seen[atom] = true;
+            bump(atom);
+            if (m_levels[atom] == level())
+                ++pending;
+            else
+                learnt.push_back(m_literals[i]);
+        }
+        // Next atom on the trail to resolve
+        while (!m_seen[m_trail[--index] / 2]) ;
+        lit = m_trail[index];
+        clause = m_reasons[lit / 2];
+        m_seen[lit / 2] = false;
+    } while (--pending > 0);
+    learnt[0] = lit ^ 1;
+
+    // Jump back to the highest level in the rest of the clause.
+    size_type back(0);
+    for (CNFClause::size_type i(1); i < learnt.size(); ++i)
+    {
+        m_seen[learnt[i] / 2] = false;
+        if (m_levels[learnt[i] / 2] > back)
+        {
+            back = m_levels[learnt[i] / 2];
+            std::swap(learnt[1], learnt[i]);
+        }
+    }
+    return back;
+}
+
+// Set core to the assumptions implying the false literal lit.
+void CDCL_solver::analyzefinal(Literal lit, CNFClause & core)
+{
+    core.assign(1, lit);
+    if (m_levels[lit / 2] == 0)
+        return;
+    m_seen[lit / 2] = true;
+    for (size_type i(m_trail.size()); i-- > m_levelstarts[0]; )
+    {
+        Atom const atom(m_trail[i] / 2);
+        if (!m_seen[atom])
+            continue;
+        m_seen[atom] = false;
+        size_type const reason(m_reasons[atom]);
+        // Only assumptions are decided on the levels to analyze.
+        if (reason == NOCLAUSE)
+        {
+            core.push_back(m_trail[i]);
+            continue;
+        }
+        for (size_type j(m_begins[reason] + 1); j < m_begins[reason + 1]; ++j)
+            if (m_levels[m_literals[j] / 2] > 0)
+                m_seen[m_literals[j] / 2] = true;
+    }
+}
+
+// Undo the assignments above a level.
+void CDCL_solver::backjump(size_type level)
+{
+    if (level >= this->level())
+        return;
+    for (size_type i(m_levelstarts[level]); i < m_trail.size(); ++i)
+    {
+        Atom const atom(m_trail[i] / 2);
+        m_phases[atom] = m_values[atom] == CNFTRUE;
+        m_values[atom] = CNFNONE;
+    }
+    m_trail.resize(m_levelstarts[level]);
+    m_levelstarts.resize(level);
+    m_next = m_trail.size();
+}
+
+// Bump the activity of an atom.
+void CDCL_solver::bump(Atom atom)
+{
+    if ((m_activity[atom] += m_increment) < 1e100)
+        return;
+    // Rescale all activities.
+    for (Atom i(0); i < m_activity.size(); ++i)
+        m_activity[i] *= 1e-100;
+    m_increment *= 1e-100;
+}
+
+// Pick the next literal to decide. Return false if all are assigned.
+bool CDCL_solver::decide(Literal & lit) const
+{
+    Atom best(m_values.size());
+    for (Atom atom(0); atom < m_values.size(); ++atom)
+        if (m_values[atom] == CNFNONE &&
+            (best == m_values.size() || m_activity[atom] > m_activity[best]))
+            best = atom;
+    if (best == m_values.size())
+        return false;
+    // Use the saved phase.
+    lit = best * 2 + !m_phases[best];
+    return true;
+}
+
+// Load the SAT instance. Return false if it is unsatisfiable already.
+bool CDCL_solver::load()
+{
+    Atom const atomcount(rcnf.atomcount());
+    m_literals.clear();
+    m_begins.assign(1, 0);
+    // Keep the space of the watch lists for the next instance.
+    m_watches.resize(atomcount * 2);
+    FOR (std::vector<size_type> & watches, m_watches)
+        watches.clear();
+    m_values.assign(atomcount, CNFNONE);
+    m_levels.assign(atomcount, 0);
+    m_reasons.assign(atomcount, NOCLAUSE);
+    m_activity.assign(atomcount, 0);
+    m_phases.assign(atomcount, false);
+    m_increment = 1;
+    m_trail.clear();
+    m_levelstarts.clear();
+    m_next = 0;
+    m_seen.assign(atomcount, false);
+
+    m_okay = false;
+    FOR (CNFClauses::const_reference clause, rcnf)
+        if (!addclause(clause))
+            return false;
+
+    return m_okay = propagate() == NOCLAUSE;
+}
+
+// Return true if the SAT instance is satisfiable with the assumptions.
+// If not and core != NULL, set it to the assumptions used to refute.
+bool CDCL_solver::solve(CNFClause const & assumptions, CNFClause * core)
+{
+    if (core)
+        core->clear();
+    if (!m_okay)
+        return false;
+    backjump(0);
+
+    CNFClause learnt;
+    for (size_type restart(0); ; ++restart)
+    {
+        // # conflicts before the next restart
+        size_type const limit(100 * luby(restart));
+        for (size_type conflicts(0); ; )
+        {
+            size_type const conflict(propagate());
+            if (conflict != NOCLAUSE)
+            {
+                if (level() == 0)
+                    return m_okay = false;
+                backjump(analyze(conflict, learnt));
+                if (learnt.size() == 1)
+                    assign(learnt[0], NOCLAUSE);
+                else
+                {
+                    // Add the learnt clause, watching its first 2 literals.
+                    size_type const c(m_begins.size() - 1);
+                    m_literals.insert(m_literals.end(),
+                                      learnt.begin(), learnt.end());
+                    m_begins.push_back(m_literals.size());
+                    m_watches[learnt[0]].push_back(c);
+                    m_watches[learnt[1]].push_back(c);
+                    assign(learnt[0], c);
+                }
+                m_increment /= 0.95;
+                ++conflicts;
+                continue;
+            }
+            if (conflicts >= limit)
+            {
+                backjump(0);
+                break;
+            }
+            Literal lit;
+            if (level() < assumptions.size())
+            {
+                // Assume the next literal.
+                lit = assumptions[level()];
+                if (value(lit) == CNFFALSE)
+                {
+                    if (core)
+                        analyzefinal(lit, *core);
+                    return false;
+                }
+                if (value(lit) == CNFTRUE)
+                {
+                    // Keep the levels in step with the assumptions.
+                    m_levelstarts.push_back(m_trail.size());
+                    continue;
+                }
+            }
+            else if (!decide(lit))
+                return true;
+            ++decisions;
+            m_levelstarts.push_back(m_trail.size());
+            assign(lit, NOCLAUSE);
+        }
+    }
+}
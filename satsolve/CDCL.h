@@ -0,0 +1,74 @@
+#ifndef CDCL_H_INCLUDED
+#define CDCL_H_INCLUDED
+
+#include "../sat.h"
+
+// Conflict driven clause learning solver, with 2 watched literals,
+// 1-UIP learning, non-chronological backjumping and Luby restarts.
+// It can be called repeatedly under different assumptions,
+// keeping the clauses learnt.
+class CDCL_solver : public Satsolver
+{
+public:
+    CDCL_solver(CNFClauses const & cnf) : Satsolver(cnf), m_okay(false) {}
+    // Return true if the SAT instance is satisfiable.
+    bool sat() { return load() && solve(CNFClause()); }
+    // Load the SAT instance. Return false if it is unsatisfiable already.
+    bool load();
+    // Return true if the SAT instance is satisfiable with the assumptions.
+    // If not and core != NULL, set it to the assumptions used to refute.
+    bool solve(CNFClause const & assumptions, CNFClause * core = NULL);
+private:
+    typedef std::size_t size_type;
+    // No clause
+    static size_type const NOCLAUSE = static_cast<size_type>(-1);
+    // Literals of clause c are [m_begins[c], m_begins[c + 1]).
+    // The first 2 literals are watched.
+    std::vector<Literal> m_literals;
+    std::vector<size_type> m_begins;
+    // Clauses watching each literal
+    std::vector<std::vector<size_type> > m_watches;
+    // Value, decision level and reason clause of each atom
+    std::vector<int> m_values;
+    std::vector<size_type> m_levels, m_reasons;
+    // Activity and saved phase of each atom
+    std::vector<double> m_activity;
+    Bvector m_phases;
+    double m_increment;
+    // Literals assigned, in order, and where each decision level starts
+    std::vector<Literal> m_trail;
+    std::vector<size_type> m_levelstarts;
+    // Index of the next literal on the trail to propagate
+    size_type m_next;
+    // Atoms seen in conflict analysis
+    Bvector m_seen;
+    // Clause being added
+    CNFClause m_clause;
+    // False if a contradiction is found without assumptions
+    bool m_okay;
+    // Truth value of a literal
+    int value(Literal lit) const
+    {
+        int const v(m_values[lit / 2]);
+        return v == CNFNONE ? v : v ^ static_cast<int>(lit % 2);
+    }
+    size_type level() const { return m_levelstarts.size(); }
+    // Add a clause. Return false if it is empty.
+    bool addclause(CNFClauseview const & clause);
+    // Make a literal true, for a reason clause.
+    void assign(Literal lit, size_type reason);
+    // Propagate the trail. Return the conflicting clause, or NOCLAUSE.
+    size_type propagate();
+    // Learn a clause from a conflict. Return the level to jump back to.
+    size_type analyze(size_type conflict, CNFClause & learnt);
+    // Set core to the assumptions implying the false literal lit.
+    void analyzefinal(Literal lit, CNFClause & core);
+    // Undo the assignments above a level.
+    void backjump(size_type level);
+    // Bump the activity of an atom.
+    void bump(Atom atom);
+    // Pick the next literal to decide. Return false if all are assigned.
+    bool decide(Literal & lit) const;
+};
+
+#endif // CDCL_H_INCLUDED
@@ -27,65 +27,76 @@ using namespace std;
  */
 typedef std::size_t uint;
 
+/**
+ * The state of the solver is kept per thread, so that instances can be solved
+ * on several threads at once.
+ */
+
 /**
  * The number of variables of the satisfiability problem.
  */
-uint numVariables;
+thread_local uint numVariables;
 
 /**
  * The number of clauses of the formula of the satisfiability problem.
  */
-uint numClauses;
+thread_local uint numClauses;
 
 /**
  * The list of clauses of the problem.
  */
-sCNF scnf;
+thread_local sCNF scnf;
 
 /**
  * The occurrence list of positive appearances for each value in the clause set.
  */
-vector<vector<sCNFClause* > > positiveClauses;
+thread_local vector<vector<sCNFClause* > > positiveClauses;
 
 /**
  * The occurrence list of negative appearances for each value in the clause set.
  */
-vector<vector<sCNFClause* > > negativeClauses;
+thread_local vector<vector<sCNFClause* > > negativeClauses;
 
 /**
  * The current model (interpretation) of the problem.
  */
-vector<int> model;
+thread_local vector<int> model;
 
 /**
  * The stack that tracks the current execution state (the backtrack stack).
  */
-vector<sLiteral> modelStack;
+thread_local vector<sLiteral> modelStack;
 
 /**
  * An index indicating which is the next literal from the stack to be propagated.
  */
-uint indexOfNextLiteralToPropagate;
+thread_local uint indexOfNextLiteralToPropagate;
 
 /**
  * The current decision level of the DPLL algorithm.
  */
-uint decisionLevel;
+thread_local uint decisionLevel;
 
 /**
  * The activity (number of conflicts in which appears) for each positive literal.
  */
-vector<double> positiveLiteralActivity;
+thread_local vector<double> positiveLiteralActivity;
 
 /**
  * The activity (number of conflicts in which appears) for each negative literal.
  */
-vector<double> negativeLiteralActivity;
+thread_local vector<double> negativeLiteralActivity;
 
 /**
  * The total number of conflicts found during the DPLL execution.
  */
-uint conflicts;
+thread_local uint conflicts;
+
+/**
+ * The number of decisions and propagated literals since the CNF was read.
+ */
+thread_local uint decisions;
+thread_local uint propagations;
 
 /**
  * Returns the variable that this literal represents.
@@ -138,6 +149,7 @@ void parseInput(CNFClauses const & cnf) {
 	positiveLiteralActivity.assign(numVariables + 1, 0.0);
 	negativeLiteralActivity.assign(numVariables + 1, 0.0);
 	conflicts = 0;
+	decisions = propagations = 0;
 }
 
 /**
@@ -209,6 +221,7 @@ bool propagateGivesConflict() {
 	while (indexOfNextLiteralToPropagate < modelStack.size()) {
 		//retrieve the literal to be propagated and move forward to the next.
 		sLiteral literalToPropagate = modelStack[indexOfNextLiteralToPropagate++];
+		++propagations;
 
 		//traverse only positive/negative appearances
 		const vector<sCNFClause* >& clausesToPropagate = literalToPropagate>0 ?
@@ -320,6 +333,7 @@ bool doDPLL() {
 			return true;
 		}
 		// start new decision level:
+		++decisions;
 		modelStack.push_back(DECISION_MARK);  // push mark indicating new
 		++indexOfNextLiteralToPropagate;
 		++decisionLevel;
@@ -327,6 +341,14 @@ bool doDPLL() {
 	}
 }
 
+/**
+ * Returns the number of decisions and propagations made since the CNF was read.
+ */
+void getCounts(std::size_t & decisionCount, std::size_t & propagationCount) {
+	decisionCount = decisions;
+	propagationCount = propagations;
+}
+
 /**
  * Checks for any unit clause and sets the appropriate values in the
  * model accordingly. If a contradiction is found among these unit clauses,
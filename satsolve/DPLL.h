@@ -33,11 +33,21 @@ bool checkUnitClauses();
  */
 bool doDPLL();
 
+/**
+ * Returns the number of decisions and propagations made since the CNF was read.
+ */
+void getCounts(std::size_t & decisions, std::size_t & propagations);
+
 class DPLL_solver : public Satsolver
 {
 public:
     DPLL_solver(CNFClauses const & cnf) : Satsolver(cnf) { parseInput(cnf); }
-    bool sat() const { return checkUnitClauses() and doDPLL(); }
+    bool sat()
+    {
+        bool const result(checkUnitClauses() and doDPLL());
+        getCounts(decisions, propagations);
+        return result;
+    }
 };
 
 #endif // DPLL_H_INCLUDED
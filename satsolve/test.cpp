@@ -1,6 +1,10 @@
 #include <iostream>
 #include "../cnf.h"
 #include "../util/arith.h"
+#include "../util/filter.h"
+#include "CDCL.h"
+#include "DPLL.h"
+#include "watchlst.h"
 
 static bool checkcnffromtruthtable(Bvector const & tt)
 {
@@ -24,6 +28,12 @@ static const char * checksat(CNFClauses const & cnf, bool const sat)
 
     if (cnf.sat() != sat)
         msg = "cnfsat()";
+    else if (Satsolver(cnf).sat() != sat)
+        msg = "backtrack_sat()";
+    else if (Watchlist_solver(cnf).sat() != sat)
+        msg = "Watchlist_solver::sat()";
+    else if (CDCL_solver(cnf).sat() != sat)
+        msg = "CDCL_solver::sat()";
     else if (cnf.truthtable(0) != Bvector(1, sat))
         msg = "maptruthtable()";
     else if (!checkcnffromtruthtable(cnf.truthtable(cnf.atomcount())))
@@ -39,7 +49,7 @@ const char * testsat1()
     CNFClauses v;
     if (checksat(v, true))
         return "empty instance";
-    v.resize(1);
+    v.newclause();
     if (checksat(v, false))
         return "empty clause";
     static const Literal a[4][3] = {
@@ -55,7 +65,9 @@ const char * testsat1()
     v.push_back(CNFClause(a[3], a[3] + 2));
     if (checksat(v, true))
         return "satisfiable instance";
-    v[3][1] = 5;    // !A, !C
+    static const Literal b[2] = {1, 5}; // !A, !C
+    v.truncate(3);
+    v.push_back(CNFClauseview(b, b + 2));
     if (checksat(v, false))
         return "satisfiable instance";
 
@@ -71,19 +83,175 @@ unsigned testsat2(unsigned n)
     for (unsigned i(1); i <= n; ++i)
     {
         // Create a CNF with all possible 2^i clauses.
-        CNFClauses cnf(1u << i);
-        for (CNFClauses::size_type j(0); j < cnf.size(); ++j)
+        CNFClauses cnf;
+        for (CNFClauses::size_type j(0); j < (1u << i); ++j)
         {
-            cnf[j].resize(i);
+            cnf.newclause();
             for (CNFClause::size_type k(0); k < i; ++k)
-                cnf[j][k] = (j >> k) & 1;
+                cnf.addliteral((j >> k) & 1);
         }
         // This CNF should be UNSATISFIABLE.
-        if (cnf.sat()) return i;
+        if (cnf.sat() || Satsolver(cnf).sat() || Watchlist_solver(cnf).sat() ||
+            CDCL_solver(cnf).sat())
+            return i;
         // Remove the last clause.
-        cnf.pop_back();
+        cnf.truncate(cnf.size() - 1);
         // This CNF should be SATISFIABLE.
-        if (!cnf.sat()) return i;
+        if (!cnf.sat() || !Satsolver(cnf).sat() ||
+            !Watchlist_solver(cnf).sat() || !CDCL_solver(cnf).sat())
+            return i;
+    }
+
+    return 0;
+}
+
+// Linear congruential generator, the same on all platforms.
+// Advance the seed and return 15 random bits.
+static unsigned long nextrandom(unsigned long & seed)
+{
+    seed = (seed * 1103515245 + 12345) % 2147483648ul;
+    return seed / 65536;
+}
+
+// Random CNF with nclauses clauses of 3 literals on nvars atoms,
+// or of 1 to 3 literals if mixed.
+static CNFClauses randomcnf
+    (unsigned long & seed, Atom nvars, unsigned nclauses, bool mixed = false)
+{
+    CNFClauses cnf;
+    for (unsigned j(0); j < nclauses; ++j)
+    {
+        cnf.newclause();
+        for (unsigned l(mixed ? nextrandom(seed) % 3 : 0); l < 3; ++l)
+            cnf.addliteral(nextrandom(seed) % (nvars * 2));
+    }
+    return cnf;
+}
+
+// Test truth tables of random CNFs with up to n atoms against solving
+// each row separately. Return 0 if okay; otherwise return the # of the
+// wrong instance, from 1.
+unsigned testsat3(unsigned n)
+{
+    unsigned long seed(1);
+    unsigned count(0);
+    for (unsigned atoms(1); atoms <= n; ++atoms)
+    {
+        for (unsigned k(0); k < 30; ++k)
+        {
+            // Clauses of 1 to 3 literals, some decided by unit propagation
+            CNFClauses const & cnf(randomcnf(seed, atoms, atoms * 2, true));
+            // Free atoms, cycling through all possible counts
+            Atom const nfree(k % (cnf.atomcount() + 1));
+            ++count;
+            Bvector const & tt(cnf.truthtable(nfree));
+            if (tt.size() != Bvector::size_type(1) << nfree)
+                return count;
+            CNFClauses cnf2;
+            for (Bvector::size_type arg(0); arg < tt.size(); ++arg)
+            {
+                cnf2 = cnf;
+                for (Atom i(0); i < nfree; ++i)
+                    cnf2.closeoff(i * 2 + 1 - (arg >> i & 1));
+                if (cnf2.sat() != tt[arg])
+                    return count;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Test random 3-SAT instances with up to n atoms, around the threshold.
+// Return 0 if okay; otherwise return the # of the wrong instance, from 1.
+unsigned testsat4(unsigned n)
+{
+    unsigned long seed(1);
+    unsigned count(0);
+    for (unsigned atoms(3); atoms <= n; ++atoms)
+    {
+        for (unsigned k(0); k < 20; ++k)
+        {
+            ++count;
+            // About 4.26 clauses per atom
+            CNFClauses const & cnf(randomcnf(seed, atoms, atoms * 426 / 100));
+            bool const sat(Satsolver(cnf).sat());
+            if (DPLL_solver(cnf).sat() != sat ||
+                Watchlist_solver(cnf).sat() != sat ||
+                CDCL_solver(cnf).sat() != sat)
+                return count;
+            // Assume the first atom true and the last false.
+            CNFClause assumptions(2);
+            assumptions[0] = 0;
+            assumptions[1] = (cnf.atomcount() - 1) * 2 + 1;
+            CDCL_solver solver(cnf);
+            CNFClause core;
+            bool const satassumed(solver.load() &&
+                                  solver.solve(assumptions, &core));
+            CNFClauses cnf2(cnf);
+            cnf2.closeoff(assumptions[0]), cnf2.closeoff(assumptions[1]);
+            if (Satsolver(cnf2).sat() != satassumed)
+                return count;
+            // The assumptions in the core should be enough to refute.
+            if (satassumed)
+                continue;
+            cnf2 = cnf;
+            FOR (Literal lit, core)
+                cnf2.closeoff(lit);
+            if (Satsolver(cnf2).sat())
+                return count;
+        }
+    }
+
+    return 0;
+}
+
+// Test one CDCL solver on random 3-SAT instances with up to n atoms,
+// under a shrinking sequence of assumptions, against fresh solvers.
+// Return 0 if okay; otherwise return the # of the wrong instance, from 1.
+unsigned testsat5(unsigned n)
+{
+    unsigned long seed(1);
+    unsigned count(0);
+    for (unsigned atoms(3); atoms <= n; ++atoms)
+    {
+        for (unsigned k(0); k < 20; ++k)
+        {
+            ++count;
+            // About 3.5 clauses per atom, mostly satisfiable
+            CNFClauses const & cnf(randomcnf(seed, atoms, atoms * 35 / 10));
+            // Assume every atom, with a random sign.
+            CNFClause assumptions;
+            for (Atom atom(0); atom < cnf.atomcount(); ++atom)
+                assumptions.push_back(atom * 2 + nextrandom(seed) % 2);
+            CDCL_solver solver(cnf);
+            bool const okay(solver.load());
+            // Drop a random assumption after each call.
+            while (true)
+            {
+                CNFClause core;
+                bool const sat(okay && solver.solve(assumptions, &core));
+                CDCL_solver fresh(cnf);
+                if ((fresh.load() && fresh.solve(assumptions)) != sat)
+                    return count;
+                // The core should be among the assumptions and refute.
+                if (!sat)
+                {
+                    FOR (Literal lit, core)
+                        if (std::find(assumptions.begin(), assumptions.end(),
+                                      lit) == assumptions.end())
+                            return count;
+                    CDCL_solver fresh2(cnf);
+                    if (fresh2.load() && fresh2.solve(core))
+                        return count;
+                }
+                if (assumptions.empty())
+                    break;
+                assumptions[nextrandom(seed) % assumptions.size()] =
+                    assumptions.back();
+                assumptions.pop_back();
+            }
+        }
     }
 
     return 0;
@@ -0,0 +1,24 @@
+#ifndef TRUTHTBL_H_INCLUDED
+#define TRUTHTBL_H_INCLUDED
+
+#include <algorithm>
+#include "CDCL.h"
+
+// Solver evaluating the truth table of the first atoms, 64 rows at a time.
+// The other atoms are decided by unit propagation if possible, as they are
+// for the CNF of a formula. Rows left undecided are solved by CDCL.
+class Truthtable_solver : public Satsolver
+{
+public:
+    Truthtable_solver(CNFClauses const & cnf) : Satsolver(cnf) {}
+    bool sat()
+    {
+        // # atoms in the truth table, up to 64 words of rows
+        static Atom const maxnfree(CNFModels::wordatoms + 6);
+        Atom const nfree(std::min(maxnfree, rcnf.atomcount()));
+        Bvector const & table(truthtable(nfree, solvesat<CDCL_solver>));
+        return std::find(table.begin(), table.end(), true) != table.end();
+    }
+};
+
+#endif // TRUTHTBL_H_INCLUDED
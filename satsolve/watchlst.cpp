@@ -12,8 +12,8 @@ Watchlist_solver::Watchlist::Watchlist(CNFClauses const & cnf)
     if (empty())
         std::cerr << "ERROR: empty watch list for CNF:\n" << cnf;
     // Each clause watches its first literal.
-    FOR (CNFClause const & clause, cnf)
-        (*this)[clause[0]].push_back(&clause - cnf.data());
+    for (CNFClauses::size_type i(0); i < cnf.size(); ++i)
+        (*this)[cnf[i][0]].push_back(i);
 }
 
 // Updates the watch list after literal falseliteral is assigned FALSE
@@ -2,7 +2,6 @@
 #include "ass.h"
 #include "getproof.h"
 #include "util/filter.h"
-#include "util/find.h"
 #include "util/for.h"
 #include "msg.h"
 #include "scope.h"
@@ -21,6 +20,20 @@ bool Scopes::pop_back()
 {
     if (size() > 1)
     {
+        // Remove the hypotheses and variables of the scope from the indices.
+        FOR (Hypiter iter, back().activehyp)
+        {
+            m_hyps.erase(iter->first);
+            if (iter->second.second)
+            {
+                Index::iterator const loc
+                    (m_variables.find(iter->second.first[1]));
+                if (loc != m_variables.end())
+                    loc->second = NULL;
+            }
+        }
+        FOR (strview var, back().activevariables)
+            m_variables.erase(var);
         std::vector<Scope>::pop_back();
         return true;
     }
@@ -28,46 +41,42 @@ bool Scopes::pop_back()
     return false;
 }
 
+// Add an active variable to the innermost scope.
+void Scopes::addvariable(strview var)
+{
+    back().activevariables.push_back(var);
+    m_variables[var] = NULL;
+}
+
+// Add an active hypothesis to the innermost scope.
+void Scopes::addhyp(Hypiter iter)
+{
+    back().activehyp.push_back(iter);
+    m_hyps[iter->first] = &*iter;
+    if (iter->second.second)
+        m_variables[iter->second.first[1]] = &*iter;
+}
+
 // Find active floating hypothesis corresponding to variable.
 // Return its name or NULL if there isn't one.
 Hypptr Scopes::getfloatinghyp(strview var) const
 {
-    FOR (const_reference scope, *this)
-    {
-//std::cout << "scope " << &scope - data() << " has "
-//          << scope.floatinghyp.size() << " variables\n";
-        std::map<strview, Hypiter>::const_iterator const loc
-            (scope.floatinghyp.find(var));
-        if (loc != scope.floatinghyp.end())
-            return &*loc->second;
-//std::cout << var << " not found" << std::endl;
-    }
-    return NULL;
+    Index::const_iterator const loc(m_variables.find(var));
+    return loc == m_variables.end() ? NULL : loc->second;
 }
 
 // Determine if a string is an active variable.
 bool Scopes::isactivevariable(strview var) const
 {
-    FOR (const_reference scope, *this)
-    {
-        if (scope.activevariables.count(var) > 0)
-            return true;
-    }
-    return false;
+    return m_variables.count(var) > 0;
 }
 
 // Determine if a string is the label of an active hypothesis.
 // If so, return the pointer to the hypothesis. Otherwise return NULL.
 Hypptr Scopes::activehypptr(strview label) const
 {
-    FOR (const_reference scope, *this)
-    {
-        Hypiters::const_iterator const
-            iterhypvec(util::find(scope.activehyp, label));
-        if (iterhypvec != scope.activehyp.end())
-            return &**iterhypvec;
-    }
-    return NULL;
+    Index::const_iterator const loc(m_hyps.find(label));
+    return loc == m_hyps.end() ? NULL : loc->second;
 }
 
 // Determine if a floating hypothesis on a string can be added.
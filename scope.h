@@ -1,6 +1,7 @@
 #ifndef SCOPE_H_INCLUDED
 #define SCOPE_H_INCLUDED
 
+#include <unordered_map>
 #include "proof.h"
 
 // Error codes used when parsing a floating hypothesis.
@@ -9,22 +10,26 @@ enum {OKAY, TYPENOTCONST, VARNOTACTIVE, VARDEFINED, EXTRATOKEN};
 // See $4.2.8.
 struct Scope
 {
-    // Active variables
-    std::set<strview> activevariables;
-    // Iterators to active hypotheses
+    // Variables declared in this scope
+    std::vector<strview> activevariables;
+    // Iterators to hypotheses added in this scope
     Hypiters activehyp;
     // Disjoint variables restrictions
     std::vector<Symbol2s> disjvars;
-    // Map: variable -> label of active floating hypothesis
-    std::map<strview, Hypiter> floatinghyp;
 };
 
+// Nested scopes, with active variables and hypotheses of all scopes indexed.
+// Entries are removed from the indices when their scope is popped.
 struct Scopes : std::vector<Scope>
 {
     // Determine if there is only one scope. If not then print error.
     bool isouter(const char * msg = NULL) const;
     // Return true if nonempty. Otherwise return false and print error.
     bool pop_back();
+    // Add an active variable to the innermost scope.
+    void addvariable(strview var);
+    // Add an active hypothesis to the innermost scope.
+    void addhyp(Hypiter iter);
     // Find active floating hypothesis corresponding to variable.
     // Return its pointer or NULL if there isn't one.
     Hypptr getfloatinghyp(strview var) const;
@@ -44,6 +49,12 @@ struct Scopes : std::vector<Scope>
     // Complete an Assertion from its Expression. That is, determine the
     // mandatory hypotheses and disjoint variable restrictions and the #.
     void completeass(struct Assertion & ass) const;
+private:
+    typedef std::unordered_map<strview, Hypptr, strviewhash> Index;
+    // Map: active variable -> its active floating hypothesis or NULL
+    Index m_variables;
+    // Map: label -> active hypothesis
+    Index m_hyps;
 };
 
 #endif // SCOPE_H_INCLUDED
@@ -6,6 +6,8 @@ static bool loopsback(Goal goal, SearchBase::TreeNoderef treenode)
 {
     SearchBase::TreeNoderef ournode(SearchBase::isourturn(treenode) ?
                                     treenode.get() : treenode.parent());
+    if (!(ournode.value().game().ancestors & Node::goalbit(goal.prPolish)))
+        return false;
     while (true)
     {
         Node const & node(ournode.value().game());
@@ -96,6 +98,51 @@ bool loopsback(SearchBase::TreeNoderef node)
     return false;
 }
 
+// Prior of a move: {# new goals, total length of new goals, -# successes}
+typedef std::pair<std::pair<Hypsize, Proofsize>, long> Prior;
+
+// Order our moves by prior for progressive widening: fewer new goals,
+// shorter new goals, then more goals proved by the assertion so far.
+void SearchBase::ordermoves(TreeNoderef node, Moves & moves) const
+{
+    if (!isourturn(node))
+        return;
+
+    std::vector<std::pair<Prior, Moves::size_type> > priors(moves.size());
+    for (Moves::size_type i(0); i < moves.size(); ++i)
+    {
+        Move const & move(moves[i]);
+        Prior & prior(priors[i].first);
+        priors[i].second = i;
+        if (move.type != Move::ASS)
+        {
+            // Defer last
+            prior.first.first = std::numeric_limits<Hypsize>::max();
+            continue;
+        }
+        for (Hypsize j(0); j < move.hypvec.size(); ++j)
+        {
+            Goalptr const goalptr(move.hypvec[j]);
+            if (!goalptr || goalptr->second.status == PROVEN)
+                continue;
+            ++prior.first.first;
+            prior.first.second += goalptr->first.size();
+        }
+        std::map<Assptr, size_type>::const_iterator const
+            iter(m_successes.find(move.pass));
+        if (iter != m_successes.end())
+            prior.second = -static_cast<long>(iter->second);
+    }
+    // Ties keep the order of generation.
+    std::sort(priors.begin(), priors.end());
+
+    Moves result;
+    result.reserve(moves.size());
+    for (Moves::size_type i(0); i < priors.size(); ++i)
+        result.push_back(moves[priors[i].second]);
+    moves.swap(result);
+}
+
 // Format: ax-mp[!]
 static void printrefname(SearchBase::TreeNoderef node)
 {
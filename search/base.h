@@ -8,20 +8,20 @@
 // Proof search tree base class, implementing loop detection
 struct SearchBase : Environ, MCTS2<Node>
 {
-    enum { STAGED = 1 };
+    // Flags in params[2]. PN = proof-number search instead of MCTS.
+    enum { STAGED = 1, WIDEN = 2, PN = 4 };
     SearchBase(Assertion const & ass, Database const & db,
                double const params[3], Assertions::size_type number = 0) :
         Environ(ass, db, number ? number : ass.number,
                 static_cast<unsigned>(params[2]) & STAGED),
         MCTS2(Node(), params)
-    {
-        if (ass.expression.empty()) return;
-        Goalptr goalptr(addgoal(ass.exprPolish));
-        // The node is copied when constructing the search tree,
-        // making the pointer to parent dangling, so it must be reset.
-        const_cast<Node &>(root().value().game()) =
-        Node(goalptr, ass.expression[0], this);
-    }
+    { init(ass, params); }
+    // Construct a sub environment of the root.
+    SearchBase(Assertion const & ass, Environ const & root,
+               double const params[3]) :
+        Environ(ass, root, static_cast<unsigned>(params[2]) & STAGED),
+        MCTS2(Node(), params)
+    { init(ass, params); }
     // UCB threshold for generating a new batch of moves
     // Change this to turn on staged move generation.
     virtual double UCBnewstage(TreeNoderef treenode) const
@@ -46,6 +46,15 @@ struct SearchBase : Environ, MCTS2<Node>
                 isourturn(treenode) ? node.penv->evalourleaf(node) :
                     node.penv->evaltheirleaf(node);
     }
+    // Evaluate a node lost so far with moves pending, as a leaf.
+    // Hypotheses are not trimmed, as its moves have been generated.
+    virtual Eval evalpending(TreeNoderef treenode) const
+    {
+        Node const & node(treenode.value().game());
+        return isourturn(treenode) ?
+            eval(node.penv->hypslen + node.goalptr->first.size()
+                 + node.defercount) : node.penv->evaltheirleaf(node);
+    }
     virtual Eval evalparent(TreeNoderef treenode) const
     {
         Node const & node(treenode.value().game());
@@ -54,11 +63,15 @@ struct SearchBase : Environ, MCTS2<Node>
             return node.penv->evalourleaf(node); // Current stage no valid attempt
         return Eval(value, std::abs(value) == WIN);
     }
+    // Order our moves by prior for progressive widening: fewer new goals,
+    // shorter new goals, then more goals proved by the assertion so far.
+    virtual void ordermoves(TreeNoderef node, Moves & moves) const;
     // Record the proof of proven goals on back propagation.
     virtual void backpropcallback(TreeNoderef node)
     {
-        if (value(node) == WIN)
-            node.value().game().writeproof();
+        Node const & game(node.value().game());
+        if (value(node) == WIN && game.writeproof())
+            ++m_successes[game.attempt.pass];
     }
     // Proof of the assertion, if any
     Proofsteps const & proof() const
@@ -72,6 +85,21 @@ struct SearchBase : Environ, MCTS2<Node>
     void printstats() const;
     void navigate(bool detailed = true) const;
     virtual ~SearchBase() {}
+private:
+    // Map: assertion -> # goals it proved in the search
+    std::map<Assptr, size_type> m_successes;
+    // Set up widening and the root of the search tree.
+    void init(Assertion const & ass, double const params[3])
+    {
+        if (static_cast<unsigned>(params[2]) & WIDEN)
+            setwidening(4, 0.5);
+        if (ass.expression.empty()) return;
+        Goalptr goalptr(addgoal(ass.exprPolish));
+        // The node is copied when constructing the search tree,
+        // making the pointer to parent dangling, so it must be reset.
+        const_cast<Node &>(root().value().game()) =
+        Node(goalptr, ass.expression[0], this);
+    }
 };
 
 #endif // BASE_H_INCLUDED
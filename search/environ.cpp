@@ -1,5 +1,6 @@
 #include "environ.h"
 #include "node.h"
+#include "stats.h"
 
 // Check if all hypotheses of a move are valid.
 bool Environ::valid(Move const & move) const
@@ -13,7 +14,7 @@ bool Environ::valid(Move const & move) const
         Proofsteps const & goal(move.hyprPolish(i));
         Goalptr goalptr(const_cast<Environ *>(this)->addgoal(goal, NEW));
         // Status of the goal
-        Goalstatus & status(goalptr->second.status);
+        std::atomic<Goalstatus> const & status(goalptr->second.status);
         if (status == FALSE)
             return false; // Invalid goal
         // Record the goal in the hypotheses of the move.
@@ -22,11 +23,11 @@ bool Environ::valid(Move const & move) const
         done(goalptr, move.hyptypecode(i));
         if (status != NEW) // status == PROVEN || status == PENDING
             continue; // Valid goal
-        // New goal
-        if ((status = valid(goal) ? PENDING : FALSE) == FALSE)
+        // New goal. Simplify hypotheses needed if valid.
+        bool const isvalid(valid(goal));
+        if (goalptr->second.settle(isvalid, isvalid ? hypstotrim(goalptr) :
+                                   Bvector()) == FALSE)
             return false; // Invalid goal
-        // Simplify hypotheses needed.
-        goalptr->second.hypstotrim = hypstotrim(goalptr);
 //std::cout << "added " << goalptr << " in " << this;
 //std::cout << ' ' << goalptr->first << goalptr->second.hypstotrim;
     }
@@ -34,11 +35,22 @@ bool Environ::valid(Move const & move) const
     return true;
 }
 
+// Order of moves by the scores of their assertions, higher first
+struct Statorder
+{
+    Assstats const & stats;
+    Statorder(Assstats const & s) : stats(s) {}
+    bool operator()(Move const & x, Move const & y) const
+    { return stats.score(x.pass) > stats.score(y.pass); }
+};
+
 // Moves generated at a given stage
 Moves Environ::ourmoves(Node const & node, stage_t stage) const
 {
     Assiters const & assvec(m_database.assvec());
-    Prooftree const & tree(prooftree(node.goalptr->first));
+    // Proof tree of the goal, reusing the space
+    thread_local static Prooftree tree;
+    tree.assign(node.goalptr->first);
     Moves moves;
 //std::cout << "Finding moves for " << node << " stage " << stage << std::endl;
     Assiters::size_type const limit(std::min(assvec.size(), m_number));
@@ -52,6 +64,9 @@ Moves Environ::ourmoves(Node const & node, stage_t stage) const
             if (tryassertion(node.goal(), tree, iter, stage, moves))
                 break; // Move closes the goal.
     }
+    // Try assertions more likely to prove the goal first.
+    if (Assstats const * const pstats = penv0->m_pstats)
+        std::stable_sort(moves.begin(), moves.end(), Statorder(*pstats));
 //std::cout << "Context " << moves.size() << std::endl;
     return moves;
 }
@@ -131,8 +146,6 @@ bool Environ::addsubenv(Node const & node)
         makeenv(subassertions[enviter->first] = node.penv->makeass(node)))
     {
 //std::cout << node.goal().expression() << "in context " << label << std::endl;
-        // Set the environment's root pointer.
-        p->penv0 = this;
         // Set the node's sub environment pointer.
         penv = enviter->second = p;
         return true;
@@ -159,6 +172,8 @@ bool Environ::addhypmoves(Move const & move, Moves & moves,
                           Subprfsteps const & subprfsteps) const
 {
     Assertion const & thm(move.pass->second);
+    // Substitutions from matching, reusing the space
+    Subprfsteps newsub;
     // Iterate through key hypotheses i of the theorem.
     FOR (Hypsize i, thm.keyhyps)
     {
@@ -169,10 +184,9 @@ bool Environ::addhypmoves(Move const & move, Moves & moves,
             if (hypj->second.second)
                 continue; // Skip floating hypotheses.
             // Match hypothesis j against key hypothesis i of the theorem.
-            Subprfsteps newsub(subprfsteps);
+            newsub = subprfsteps;
             if (findsubstitutions(m_ass.hypsrPolish[j], m_ass.hypstree[j],
-                                  thm.hypsrPolish[i], thm.hypstree[i],
-                                  newsub))
+                                  thm.hypsmatcher[i], newsub))
             {
 //std::cout << hypj->first << ' ' << m_ass.hypsrPolish[j];
                 // Free substitutions from the key hypothesis
@@ -202,8 +216,7 @@ bool Environ::tryassertion
 //std::cout << "Trying " << iter->first << " with " << goal.expression();
     Subprfsteps subprfsteps;
     prealloc(subprfsteps, ass.varsused);
-    if (!findsubstitutions(goal.prPolish, tree, ass.exprPolish, ass.exptree,
-                           subprfsteps))
+    if (!findsubstitutions(goal.prPolish, tree, ass.expmatcher, subprfsteps))
         return false; // Conclusion mismatch
     // Bound substitutions
     Move::Substitutions substitutions(subprfsteps.size());
@@ -12,18 +12,8 @@ struct Move;
 typedef std::vector<Move> Moves;
 // Node in proof search tree
 struct Node;
-
-inline const void * stepptr(Proofstep step)
-{
-    if (step.type == Proofstep::HYP)
-        return step.phyp;
-    else
-        return step.pass;
-}
-inline bool operator<(Proofstep step1, Proofstep step2)
-{
-    return std::less<const void *>()(stepptr(step1), stepptr(step2));
-}
+// Statistics of assertions
+class Assstats;
 
 // Size-based score
 inline double score(Proofsize size) { return 1. / (size + 1); }
@@ -34,16 +24,22 @@ struct Environ
 {
     Environ(Assertion const & ass, Database const & db, bool isstaged = 0) :
         m_database(db), staged(isstaged), hypslen(ass.hypslen()), m_ass(ass),
-        m_number(ass.number), penv0(this) {}
+        m_number(ass.number), penv0(this), m_goals(new Goals),
+        m_pstats(NULL) {}
     Environ(Assertion const & ass, Database const & db,
             Assertions::size_type number, bool isstaged = 0) :
         m_database(db), staged(isstaged), hypslen(ass.hypslen()), m_ass(ass),
-        m_number(number), penv0(this) {}
+        m_number(number), penv0(this), m_goals(new Goals), m_pstats(NULL) {}
+    // Construct a sub environment of the root, using the goals of the root.
+    Environ(Assertion const & ass, Environ const & root, bool isstaged = 0) :
+        m_database(root.m_database), staged(isstaged), hypslen(ass.hypslen()),
+        m_ass(ass), m_number(ass.number), penv0(const_cast<Environ *>(&root)),
+        m_goals(NULL), m_pstats(NULL) {}
     // Map: name -> polymorphic sub environments
     typedef std::map<std::string, Environ *> Subenvs;
-    // Add a goal. Return its pointer.
+    // Add a goal to the table of the root environment. Return its pointer.
     Goalptr addgoal(Proofsteps const & goal, Goalstatus s = PENDING)
-    { return &*goals.insert(Goals::value_type(goal, s)).first; }
+    { return penv0->m_goals->insert(this, goal, s); }
     // Check if an expression is proven or hypothesis.
     // If so, record its proof. Return true iff okay.
     bool done(Goalptr goalptr, strview typecode) const
@@ -55,22 +51,18 @@ struct Environ
         if (i == m_ass.hypcount())
             return false; // Hypothesis matched
         // Write the 1-step proof.
-        goalptr->second.status = PROVEN;
-        goalptr->second.proofsteps.assign(1, m_ass.hypiters[i]);
+        goalptr->second.prove(Proofsteps(1, m_ass.hypiters[i]));
         return true;
     }
-    // # goals of a given status
+    // # goals of a given status in all environments
     Goals::size_type countgoal(int status) const
-    {
-        Goals::size_type n(0);
-        FOR (Goals::const_reference goal, goals)
-            n += (goal.second.status == status);
-        FOR (Subenvs::const_reference subenv, subenvs)
-            n += subenv.second->countgoal(status);
-        return n;
-    }
+    { return penv0->m_goals->count(status); }
     // # sub environments
     Subenvs::size_type countenvs() const { return subenvs.size() + 1; }
+    // Is this the root environment?
+    bool isroot() const { return penv0 == this; }
+    // Order moves by statistics of assertions. NULL turns ordering off.
+    void setstats(Assstats const * pstats) { m_pstats = pstats; }
     // Check if an assertion is on topic.
     virtual bool ontopic(Assertion const & ass) const { return ass.number; }
     // Return the hypotheses of a goal to be trimmed.
@@ -95,6 +87,7 @@ struct Environ
     {
         FOR (Subenvs::const_reference subenv, subenvs)
             delete subenv.second;
+        delete m_goals;
     }
     // Database to be used
     Database const & m_database;
@@ -110,8 +103,10 @@ private:
     Assertions::size_type const m_number;
     // Pointer to the root environment
     Environ * penv0;
-    // Set of goals looked at
-    Goals goals;
+    // Goals looked at in all environments, only allocated at the root
+    Goals * const m_goals;
+    // Statistics to order moves by, used from the root
+    Assstats const * m_pstats;
     // Assertions corresponding to sub environments
     Assertions subassertions;
     // Polymorphic sub environments
@@ -1,7 +1,14 @@
 #ifndef GOAL_H_INCLUDED
 #define GOAL_H_INCLUDED
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
 #include "../proof/verify.h"
+#include "../util/hash.h"
 
 // Proof goal
 struct Goal
@@ -21,19 +28,125 @@ struct Goal
 // Proof status of a goal
 enum Goalstatus {PROVEN = 1, PENDING = 0, FALSE = -1, NEW = -2};
 
-// Data associated with the goal
+// Data associated with the goal, shared by all threads of a search.
+// The status is read without locking. A NEW goal matching a hypothesis is
+// proven at once, moving to PROVEN. Other NEW goals are settled as PENDING or
+// FALSE, and PENDING ones may later move to PROVEN. The hypotheses to trim are
+// written on settling, and the proof on becoming PROVEN, both at most once.
 struct Goaldata
 {
-    Goalstatus status;
-    // Proof of the expression
+    std::atomic<Goalstatus> status;
+    // Proof of the expression, valid once the status is PROVEN
     Proofsteps proofsteps;
-    Goaldata(Goalstatus s = PENDING, Proofsteps const & steps = Proofsteps()) :
-        status(s), proofsteps(steps) {}
-    // Unnecessary hypothesis of the goal
+    // Unnecessary hypothesis of the goal, valid once settled,
+    // empty if the goal was proven while NEW
     Bvector hypstotrim;
+    explicit Goaldata(Goalstatus s = PENDING) : status(s)
+    { m_writing.clear(); }
+    // Settle a new goal as PENDING or FALSE, with the hypotheses to trim.
+    // Do nothing if it is no longer new. Return the status afterwards.
+    Goalstatus settle(bool valid, Bvector const & totrim)
+    {
+        lock();
+        if (status == NEW)
+        {
+            hypstotrim = totrim;
+            status = valid ? PENDING : FALSE;
+        }
+        unlock();
+        return status;
+    }
+    // Publish the proof of the goal. Return true iff it was not proven before.
+    bool prove(Proofsteps const & steps)
+    {
+        if (status == PROVEN)
+            return false;
+        lock();
+        bool const first(status != PROVEN);
+        if (first)
+        {
+            proofsteps = steps;
+            status = PROVEN;
+        }
+        unlock();
+        return first;
+    }
+private:
+    // Held while writing, taken only by writers
+    std::atomic_flag m_writing;
+    void lock() { while (m_writing.test_and_set(std::memory_order_acquire))
+                      std::this_thread::yield(); }
+    void unlock() { m_writing.clear(std::memory_order_release); }
+};
+
+// Table of goals, safe to use from many threads. Goals are keyed by the
+// environment they are in and by their rev Polish notation. Insertion locks
+// one of a few shards picked by hash. Entries never move or get erased.
+class Goals
+{
+    // Address of the hypothesis or assertion of a proof step
+    static const void * stepptr(Proofstep step)
+    {
+        if (step.type == Proofstep::HYP)
+            return step.phyp;
+        else
+            return step.pass;
+    }
+    // Order of goals by the addresses of their steps
+    struct Goalorder
+    {
+        bool operator()(Proofstep x, Proofstep y) const
+        { return std::less<const void *>()(stepptr(x), stepptr(y)); }
+        bool operator()(Proofsteps const & x, Proofsteps const & y) const
+        {
+            return std::lexicographical_compare(x.begin(), x.end(),
+                                                y.begin(), y.end(), *this);
+        }
+    };
+public:
+    typedef std::map<Proofsteps, Goaldata, Goalorder> Map;
+    typedef Map::pointer pointer;
+    typedef Map::size_type size_type;
+    // Add a goal in an environment, if not present. Return its pointer.
+    pointer insert(const void * env, Proofsteps const & goal, Goalstatus s)
+    {
+        util::Hash h(util::hash(util::hashbasis, env));
+        FOR (Proofstep step, goal)
+            h = util::hash(h, stepptr(step));
+        Shard & shard(m_shards[h % SHARDS]);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Map & map(shard.maps[env]);
+        Map::iterator const iter(map.lower_bound(goal));
+        if (iter != map.end() && !map.key_comp()(goal, iter->first))
+            return &*iter;
+        return &*map.emplace_hint(iter, std::piecewise_construct,
+                                  std::forward_as_tuple(goal),
+                                  std::forward_as_tuple(s));
+    }
+    // # goals of a given status
+    size_type count(int status) const
+    {
+        size_type n(0);
+        for (unsigned i(0); i < SHARDS; ++i)
+        {
+            std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+            FOR (Shard::Maps::const_reference map, m_shards[i].maps)
+                FOR (Map::const_reference goal, map.second)
+                    n += (goal.second.status == status);
+        }
+        return n;
+    }
+private:
+    enum { SHARDS = 16 };
+    struct Shard
+    {
+        std::mutex mutex;
+        typedef std::map<const void *, Map> Maps;
+        Maps maps;
+    };
+    Shard mutable m_shards[SHARDS];
 };
-// Map: goal -> Evaluation
-typedef std::map<Proofsteps, Goaldata> Goals;
 // Pointer to a goal
 typedef Goals::pointer Goalptr;
 
@@ -3,8 +3,9 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <iterator>
 #include "../io.h"
-#include "../util/iter.h"
+#include "../util/hash.h"
 #include "move.h"
 #include "../MCTS/stageval.h"
 
@@ -13,6 +14,14 @@ struct Node
 {
     typedef ::Move Move;
     typedef ::Moves Moves;
+    // Set of goals as 64 bits, each goal setting one of them.
+    // A goal whose bit is not set is not in the set.
+    typedef unsigned long long Signature;
+    static Signature goalbit(Proofsteps const & prPolish)
+    {
+        util::Hash const h(util::hash(util::hashbasis, &prPolish));
+        return Signature(1) << (h >> 58);
+    }
     // Pointer to rev Polish of expression to be proved
     Goalptr goalptr;
     strview typecode;
@@ -21,22 +30,29 @@ struct Node
     std::size_t defercount;
     // Pointer to the parent, for deferred nodes
     Node const * pparent;
+    // Signature of the goals of this node and its ancestors on our turn,
+    // not deferred
+    Signature ancestors;
     // Proof attempt made, on their turn
     Move attempt;
-    // Essential hypotheses needed, on their turn
+    // Essential hypotheses needed, on their turn, sorted without duplicates
     struct Compgoal : std::less<Goalptr>
     {
 //        bool operator()(Goalptr p, Goalptr q) const
 //        { return p->first < q->first; }
     };
-    std::set<Goalptr, Compgoal> hypset;
+    typedef std::vector<Goalptr> Hypset;
+    Hypset hypset;
+    // Signature of the goals in hypset
+    Signature hypsig;
     // Pointer to the current environment
     Environ *penv;
     Node(Goalptr pgoal = NULL, strview type = NULL, Environ * p = NULL) :
-        goalptr(pgoal), typecode(type), defercount(0), penv(p) {}
+        goalptr(pgoal), typecode(type), defercount(0),
+        ancestors(pgoal ? goalbit(pgoal->first) : 0), hypsig(0), penv(p) {}
     Node(Node const & node) :
         goalptr(node.goalptr), typecode(node.typecode), defercount(node.defercount), pparent(&node),
-        penv(node.penv) {}
+        ancestors(node.ancestors), hypsig(0), penv(node.penv) {}
     friend std::ostream & operator<<(std::ostream & out, Node const & node)
     {
         out << node.goal().expression();
@@ -48,13 +64,21 @@ struct Node
     // Set the hypothesis set of a node.
     void sethyps()
     {
+        hypset.clear();
         std::remove_copy_if(attempt.hypvec.begin(), attempt.hypvec.end(),
-                            end_inserter(hypset),
+                            std::back_inserter(hypset),
                             std::logical_not<const void *>());
+        std::sort(hypset.begin(), hypset.end(), Compgoal());
+        hypset.erase(std::unique(hypset.begin(), hypset.end()), hypset.end());
+        hypsig = 0;
+        FOR (Goalptr goalptr, hypset)
+            hypsig |= goalbit(goalptr->first);
     }
     // Check if the hypotheses of node 1 includes those of node 2.
     bool operator>=(Node const & node) const
     {
+        if (node.hypsig & ~hypsig)
+            return false;
         return std::includes(hypset.begin(), hypset.end(),
                              node.hypset.begin(), node.hypset.end(), Compgoal());
     }
@@ -86,6 +110,7 @@ struct Node
             // Pick the hypothesis.
             goalptr = lastmove.hypvec[move.index];
             typecode = lastmove.hyptypecode(move.index);
+            ancestors |= goalbit(goalptr->first);
         }
     }
     Moves theirmoves() const
@@ -121,10 +146,11 @@ struct Node
         return ourturn ? ourmoves(stage) : stage > 0 ? Moves() : theirmoves();
     }
     // Add proof for a node using an assertion.
-    void writeproof() const
+    // Return true iff the goal was not proven before.
+    bool writeproof() const
     {
         if (attempt.type != Move::ASS)
-            return;
+            return false;
         // Pointers to proofs of hypotheses
         pProofs hyps(attempt.hypcount());
         for (Hypsize i(0); i < attempt.hypcount(); ++i)
@@ -136,8 +162,9 @@ struct Node
 //std::cout << "Added hyp\n" << *hyps.back();
         }
         // The whose proof
-        goalptr->second.status = PROVEN;
-        ::writeproof(goalptr->second.proofsteps, attempt.pass, hyps);
+        Proofsteps proof;
+        ::writeproof(proof, attempt.pass, hyps);
+        return goalptr->second.prove(proof);
 //std::cout << penv << " proves " << goal().expression();
 //std::cout << goalptr->second.proofsteps;
     }
@@ -0,0 +1,81 @@
+#ifndef PNSEARCH_H_INCLUDED
+#define PNSEARCH_H_INCLUDED
+
+#include "base.h"
+#include "../MCTS/PNS.h"
+
+// Proof-number search for the goal of a proof search tree,
+// using the environments of the tree
+struct PNSearch : PNS<Node>
+{
+    PNSearch(SearchBase const & tree) :
+        PNS<Node>(tree.root().value().game()), m_env(tree) {}
+    // Check if the goal appears as the goal of an ancestor of our turn.
+    static bool loopsback(Goal goal, TreeNode const * ournode)
+    {
+        if (ournode &&
+            !(ournode->state.game().ancestors & Node::goalbit(goal.prPolish)))
+            return false;
+        for ( ; ournode; ournode = ournode->parent ? ournode->parent->parent :
+                                   NULL)
+        {
+            Node const & node(ournode->state.game());
+            if (node.defercount == 0 && goal == node.goal())
+                return true;
+        }
+        return false;
+    }
+    // Check if a hypothesis of the attempt of a node on their turn
+    // appears as the goal of an ancestor.
+    static bool loopsback(TreeNode const & node)
+    {
+        Move const & move(node.state.game().attempt);
+        if (move.type != Move::ASS)
+            return false;
+        for (Hypsize i(0); i < move.hypcount(); ++i)
+        {
+            if (move.isfloating(i))
+                continue; // Skip floating hypotheses.
+            Goal goal = {move.hypvec[i]->first, move.hyptypecode(i)};
+            if (loopsback(goal, node.parent))
+                return true;
+        }
+        return false;
+    }
+    virtual Eval evalleaf(TreeNode const & treenode) const
+    {
+        Node const & node(treenode.state.game());
+        if (!treenode.state.isourturn())
+            return loopsback(treenode) ? Eval(LOSS, true) :
+                node.penv->evaltheirleaf(node);
+        return m_env.done(node.goalptr, node.typecode) ? Eval(WIN, true) :
+            node.penv->evalourleaf(node);
+    }
+    // Proof number of an unsolved leaf: total length of open goals
+    virtual Number initpn(TreeNode const & treenode) const
+    {
+        Node const & node(treenode.state.game());
+        if (treenode.state.isourturn())
+            return node.goalptr->first.size() * (node.defercount + 1);
+        Move const & move(node.attempt);
+        if (move.type != Move::ASS)
+            return node.goalptr->first.size() * (node.defercount + 2);
+        Number pn(0);
+        for (Hypsize i(0); i < move.hypcount(); ++i)
+            if (!move.isfloating(i) &&
+                move.hypvec[i]->second.status != PROVEN)
+                pn += move.hypvec[i]->first.size();
+        return pn ? pn : 1;
+    }
+    // Record the proof of proven goals.
+    virtual void solvedcallback(TreeNode const & treenode)
+    {
+        if (treenode.pn == 0)
+            treenode.state.game().writeproof();
+    }
+private:
+    // The root environment
+    Environ const & m_env;
+};
+
+#endif // PNSEARCH_H_INCLUDED
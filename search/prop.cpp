@@ -1,37 +1,142 @@
+#include <chrono>
+#include <sstream>
+#include "pnsearch.h"
 #include "prop.h"
+#include "stats.h"
+#include "../sat.h"
 #include "../util/progress.h"
 #include "../util/timer.h"
 
+// Return the CNF of the hypotheses, with hypothesis i only assumed
+// if the selector atom natom + i is true.
+CNFClauses Propdata::makeselectorcnf(Hypscnf const & hypscnf, Atom natom)
+{
+    CNFClauses result;
+    std::vector<CNFClauses::size_type> const & ends(hypscnf.second);
+    for (Hypsize i(0); i < ends.size(); ++i)
+    {
+        CNFClauses::size_type const begin(i > 0 ? ends[i - 1] : 0);
+        if (begin == ends[i])
+            continue; // Floating hypothesis
+        // The last clause assumes the hypothesis.
+        result.append(hypscnf.first, begin, ends[i] - 1);
+        result.push_back(hypscnf.first[ends[i] - 1]);
+        result.addliteral((natom + i) * 2 + 1);
+    }
+    return result;
+}
+
+// Check if a goal is valid.
+bool Prop::valid(Proofsteps const & goal) const
+{
+    Hypscnf const & hypscnf(m_data->hypscnf);
+    // Add the goal to the CNF of the hypotheses, and roll back after.
+    CNFClauses & cnf(isroot() ? m_data->hypscnf.first : m_data->subcnf);
+    if (!isroot())
+    {
+        // Copy the hypotheses of this environment from the root.
+        std::vector<CNFClauses::size_type> const & ends(hypscnf.second);
+        cnf.clear();
+        FOR (Hypsize i, m_roothyps)
+            cnf.append(hypscnf.first, i > 0 ? ends[i - 1] : 0, ends[i]);
+    }
+    CNFClauses::size_type const hypsize(cnf.size());
+    Atom natom(m_data->hypatomcount);
+    bool result(false);
+    if (m_database.propctors().addclause(goal, m_data->hypiters, cnf, natom))
+    {
+        cnf.closeoff((natom - 1) * 2 + 1);
+        result = !cnf.sat();
+    }
+    cnf.truncate(hypsize);
+    return result;
+}
+
 // Return the hypotheses of a goal to trim.
+// Drop essential hypotheses one by one, from the last one, as long as the goal
+// still follows. All the checks are made by one solver under assumptions.
 Bvector Prop::hypstotrim(Goalptr goalptr) const
 {
+    // Selectors of the hypotheses kept
+    CNFClause assumptions;
+    for (Hypsize i(0); i < m_ass.hypcount(); ++i)
+        if (!m_ass.hypiters[i]->second.second)
+            assumptions.push_back(selector(i));
+    if (assumptions.empty())
+        return Bvector(); // No essential hypotheses
+
     Bvector result(m_ass.hypcount(), false);
 
+    // Add the goal to the CNF of the hypotheses, and roll back after.
+    CNFClauses & cnf(m_data->selectorcnf);
+    CNFClauses::size_type const hypsize(cnf.size());
+    Atom const hypatomcount(m_data->hypatomcount);
+    Atom natom(hypatomcount + m_data->hypiters.size());
+    if (!m_database.propctors().addclause(goalptr->first, m_data->hypiters,
+                                          cnf, natom))
+    {
+        cnf.truncate(hypsize);
+        return Bvector();
+    }
+    // Negate conclusion.
+    cnf.closeoff((natom - 1) * 2 + 1);
+    CDCL_solver & solver(m_data->trimsolver);
+    // Time the solver only if the statistics are collected.
+    Satstats & stats(satstats());
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start;
+    if (stats.enabled)
+        start = Clock::now();
+    std::size_t const decisions(solver.decisions);
+    std::size_t const propagations(solver.propagations);
+    bool const okay(solver.load());
+    CNFClauses::size_type const clausecount(cnf.size());
+    cnf.truncate(hypsize);
+
+    // Last set of hypotheses of the root refuting the negated goal
+    Bvector core(m_data->hypiters.size(), false);
+    CNFClause corelits;
+    std::size_t calls(1);
     Hypsize ntotrim(0); // # essential hypothesis to trim
-    for (Hypsize i(m_ass.hypcount() - 1); i != Hypsize(-1); --i)
+    // Trim only if the goal follows.
+    if (!okay || !solver.solve(assumptions, &corelits))
     {
-        if (m_ass.hypiters[i]->second.second)
-            continue; // Skip floating hypotheses.
-        // Try to trim the i-th hypothesis.
-        result[i] = true;
-        // Check if it can be trimmed.
-        CNFClauses cnf2;
-        std::vector<CNFClauses::size_type> const & ends(hypscnf.second);
-        // Add hypotheses.
-        for (Hypsize j(0); j < m_ass.hypcount(); ++j)
+        FOR (Literal lit, corelits)
+            core[lit / 2 - hypatomcount] = true;
+
+        for (Hypsize i(m_ass.hypcount() - 1); i != Hypsize(-1); --i)
         {
-            if (m_ass.hypiters[j]->second.second || result[j])
-                continue; // Skip floating or unnecessary hypotheses.
-            CNFClauses::size_type begin(j > 0 ? ends[j - 1] : 0), end(ends[j]);
-            cnf2.insert(cnf2.end(), &hypscnf.first[begin], &hypscnf.first[end]);
+            if (m_ass.hypiters[i]->second.second)
+                continue; // Skip floating hypotheses.
+            // Try to trim the i-th hypothesis.
+            // The rest still include the core, unless it is in the core.
+            if (core[m_roothyps[i]])
+            {
+                assumptions.clear();
+                for (Hypsize j(0); j < m_ass.hypcount(); ++j)
+                    if (!m_ass.hypiters[j]->second.second &&
+                        !result[j] && j != i)
+                        assumptions.push_back(selector(j));
+                ++calls;
+                if (solver.solve(assumptions, &corelits))
+                    continue; // The i-th hypothesis is needed.
+                core.assign(core.size(), false);
+                FOR (Literal lit, corelits)
+                    core[lit / 2 - hypatomcount] = true;
+            }
+            ntotrim += result[i] = true;
         }
-//        std::cout << "hypcnf\n" << hypscnf.first << "cnf\n" << cnf2;
-        Atom natom(cnf2.empty() ? m_ass.hypcount() : cnf2.atomcount());
-        // Add conclusion.
-        m_database.propctors().addclause(goalptr->first, m_ass.hypiters, cnf2, natom);
-        // Negate conclusion.
-        cnf2.closeoff((natom - 1) * 2 + 1);
-        ntotrim += result[i] = !cnf2.sat();
+    }
+
+    if (stats.enabled)
+    {
+        stats.calls += calls;
+        stats.clauses += clausecount;
+        stats.atoms += natom;
+        stats.decisions += solver.decisions - decisions;
+        stats.propagations += solver.propagations - propagations;
+        stats.nanoseconds += std::chrono::duration_cast
+            <std::chrono::nanoseconds>(Clock::now() - start).count();
     }
 
     return ntotrim ? m_ass.trimvars(result, goalptr->first) : Bvector();
@@ -76,11 +181,11 @@ bool Prop::addhardmoves(Assiter iter, Proofsize size, Move & move,
             freevars.push_back(var.first), types.push_back(var.first.typecode());
     // Generate substitution terms.
     FOR (Symbol3 var, freevars)
-        generateupto(m_ass.varsused, syntaxioms, var.typecode(), size,
+        generateupto(m_ass.varsused, m_data->syntaxioms, var.typecode(), size,
                      genresult, termcounts);
     // Generate substitutions.
     Substadder adder(freevars, moves, move, *this);
-    dogenerate(m_ass.varsused, syntaxioms, types, size + 1,
+    dogenerate(m_ass.varsused, m_data->syntaxioms, types, size + 1,
                genresult, termcounts, adder);
 //std::cout << moves;
     return false;
@@ -90,24 +195,42 @@ bool Prop::addhardmoves(Assiter iter, Proofsize size, Move & move,
 // Return the size of tree if okay. Otherwise return 0.
 Prop::size_type testpropsearch
     (Assiter iter, Database const & database, Prop::size_type sizelimit,
-     double const parameters[3])
+     double const parameters[3], Assstats * stats)
 {
 //    printass(*iter);
     Prop tree(iter->second, database, parameters);
-    tree.play(sizelimit);
+    tree.setstats(stats);
+    // Use proof-number search instead of MCTS?
+    bool const pn(static_cast<unsigned>(parameters[2]) & SearchBase::PN);
+    // Size and value of the search tree
+    Prop::size_type size;
+    double value;
+    if (pn)
+    {
+        PNSearch pntree(tree);
+        pntree.play(sizelimit);
+        size = pntree.size(), value = pntree.value();
+    }
+    else
+    {
+        tree.play(sizelimit);
+        size = tree.size(), value = tree.value();
+    }
+    if (stats)
+        stats->add(tree, size > sizelimit ? Proofsteps() : tree.proof());
     // Check answer
 //    tree.printstats();
 //if (iter->first == "test181") tree.navigate();
-    if (tree.size() > sizelimit)
+    if (size > sizelimit)
     {
 //        std::cout << "Tree size limit exceeded. Main line:\n";
 //        tree.printmainline();
 //        tree.navigate();
     }
-    else if (tree.value() != 1)
+    else if (value != 1)
     {
-        std::cerr << "Prop search returned " << tree.value() << "\n";
-        tree.printmainline();
+        std::cerr << "Prop search returned " << value << "\n";
+        if (!pn) tree.printmainline();
         return 0;
     }
     else if (!provesrightthing(iter->first,
@@ -115,23 +238,24 @@ Prop::size_type testpropsearch
                                iter->second.expression))
     {
         std::cerr << "Wrong proof: " << tree.proof();
-        tree.navigate();
+        if (!pn) tree.navigate();
     }
     else if (iter->first == "test8")
     {
         Printer printer(&database.typecodes());
         verifyproofsteps(tree.proof(), printer, &*iter);
         std::cout << printer.str(indentation(prooftree(tree.proof())));
-        tree.navigate();
+        if (!pn) tree.navigate();
     }
 
-    return tree.size();
+    return size;
 }
 
 // Test propositional proof search. Return 1 iff okay.
+// If stats != NULL, order moves by it and add the statistics of each search.
 bool testpropsearch
     (Database const & database, Prop::size_type const sizelimit,
-     double const parameters[3])
+     double const parameters[3], Assstats * stats, bool printsat)
 {
     std::cout << "Testing propositional proof search";
     Progress progress(std::cerr);
@@ -139,6 +263,8 @@ bool testpropsearch
     bool okay(true);
     Prop::size_type nodecount(0);
     Assiters::size_type all(0), proven(0);
+    // Statistics of SAT calls for each theorem, printed after the progress bar
+    std::ostringstream satlog;
     // Test assertions
     Assiters const & assiters(database.assvec());
     for (Assiters::size_type i(1); i < assiters.size(); ++i)
@@ -167,8 +293,12 @@ bool testpropsearch
         }
 
         // Try search proof.
+        if (printsat)
+            satstats().clear();
         Prop::size_type const n(testpropsearch(iter, database, sizelimit,
-                                               parameters));
+                                               parameters, stats));
+        if (printsat)
+            satlog << iter->first << ": " << satstats();
         ++all;
         if (n == 0)
         {
@@ -181,7 +311,7 @@ bool testpropsearch
     }
     // Collect statistics.
     double const t(timer);
-    std::cout << '\n';
+    std::cout << '\n' << satlog.str();
     std::cout << nodecount << " nodes / " << t << "s = ";
     std::cout << nodecount/t << " nps\n";
     std::cout << proven << '/' << all << " = ";
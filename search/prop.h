@@ -4,20 +4,71 @@
 #include "base.h"
 #include "../cnf.h"
 #include "../disjvars.h"
+#include "../satsolve/CDCL.h"
 #include "gen.h"
 
-// Propositional proof search, using SAT pruning
+// Data of a propositional search shared by all its environments,
+// owned by the root. A search runs on one thread, and its environments
+// use the data in turn without locking.
+struct Propdata
+{
+    // Hypotheses of the root assertion
+    Hypiters const & hypiters;
+    // Relevant syntax axioms
+    Syntaxioms syntaxioms;
+    // # atoms used by the hypotheses of the root
+    Atom hypatomcount;
+    // The CNF of all hypotheses of the root combined, with room for a goal
+    Hypscnf hypscnf;
+    // The CNF of the hypotheses of the root with selectors,
+    // with room for a goal
+    CNFClauses selectorcnf;
+    // Solver for the goal and the hypotheses with selectors
+    CDCL_solver trimsolver;
+    // CNF of the hypotheses of a sub environment, reusing the space
+    CNFClauses subcnf;
+    Propdata(Assertion const & ass, Database const & db) :
+        hypiters(ass.hypiters), hypatomcount(0),
+        hypscnf(db.propctors().hypscnf(ass, hypatomcount)),
+        selectorcnf(makeselectorcnf(hypscnf, hypatomcount)),
+        trimsolver(selectorcnf)
+    {
+        FOR (Syntaxioms::const_reference syntaxiom, db.syntaxioms())
+            if (syntaxiom.second < ass.number)
+                syntaxioms.insert(syntaxiom);
+    }
+private:
+    // Return the CNF of the hypotheses, with hypothesis i only assumed
+    // if the selector atom natom + i is true.
+    static CNFClauses makeselectorcnf(Hypscnf const & hypscnf, Atom natom);
+};
+
+// Propositional proof search, using SAT pruning.
+// Sub environments share the data of the root,
+// and only keep which hypotheses of the root they have.
 struct Prop : SearchBase
 {
     Prop(Assertion const & ass, Database const & db,
          double const params[3]) :
-        SearchBase(ass, db, params),
-        hypscnf(db.propctors().hypscnf(ass, hypatomcount))
+        SearchBase(ass, db, params), m_data(new Propdata(ass, db)),
+        m_roothyps(ass.hypcount())
     {
-        // Relevant syntax axioms
-        FOR (Syntaxioms::const_reference syntaxiom, m_database.syntaxioms())
-            if (syntaxiom.second < ass.number)
-                syntaxioms.insert(syntaxiom);
+        for (Hypsize i(0); i < ass.hypcount(); ++i)
+            m_roothyps[i] = i;
+    }
+    // Construct a sub environment of the root from a sub assertion.
+    Prop(Assertion const & ass, Prop const & root, double const params[3]) :
+        SearchBase(ass, root, params), m_data(root.m_data)
+    {
+        // Match the hypotheses with those of the root, which are in order.
+        m_roothyps.reserve(ass.hypcount());
+        Hypsize j(0);
+        FOR (Hypiter iter, ass.hypiters)
+        {
+            while (m_data->hypiters[j] != iter)
+                ++j;
+            m_roothyps.push_back(j++);
+        }
     }
     // Check if an assertion is on topic/useful.
     virtual bool ontopic(Assertion const & ass) const
@@ -25,24 +76,16 @@ struct Prop : SearchBase
         return ass.type & Asstype::PROPOSITIONAL;
     }
     // Check if a goal is valid.
-    virtual bool valid(Proofsteps const & goal) const
-    {
-        CNFClauses cnf(hypscnf.first);
-        Atom natom(hypatomcount);
-        if (!m_database.propctors().addclause(goal, m_ass.hypiters, cnf, natom))
-            return false;
-        cnf.closeoff((natom - 1) * 2 + 1);
-        return !cnf.sat();
-    }
+    virtual bool valid(Proofsteps const & goal) const;
     // Return the hypotheses of a goal to trim.
     virtual Bvector hypstotrim(Goalptr goalptr) const;
     // Allocate a new sub environment constructed from a sub assertion on the heap.
-    // Return its address.
+    // Return its address. Only called on the root.
     virtual Prop * makeenv(Assertion const & ass) const
     {
         double const param[3] =
         {exploration()[0], exploration()[1], static_cast<double>(staged)};
-        return new(std::nothrow) Prop(ass, m_database, param);
+        return new(std::nothrow) Prop(ass, *this, param);
     }
     // Return the simplified assertion for the goal of the node to hold.
     virtual Assertion makeass(Node const & node) const
@@ -55,22 +98,29 @@ struct Prop : SearchBase
         result.disjvars = m_ass.disjvars & result.varsused;
         return result;
     }
-    virtual ~Prop() {}
+    virtual ~Prop() { if (isroot()) delete m_data; }
 private:
     // Add a move with free variables. Return false.
     virtual bool addhardmoves(Assiter iter, Proofsize size, Move & move,
                              Moves & moves) const;
-    Syntaxioms syntaxioms;
+    // Literal assuming the i-th hypothesis
+    Literal selector(Hypsize i) const
+    { return (m_data->hypatomcount + m_roothyps[i]) * 2; }
+    // Data shared with the root, owned by the root
+    Propdata * const m_data;
+    // Index of each hypothesis in the root assertion
+    std::vector<Hypsize> m_roothyps;
     Genresult  mutable genresult;
     Termcounts mutable termcounts;
-    // The CNF of all hypotheses combined
-    Hypscnf const hypscnf;
-    Atom hypatomcount;
 };
 
 // Test propositional proof search. Return 1 iff okay.
+// If stats != NULL, order moves by it and add the statistics of each search.
+// If printsat is true, print the statistics of SAT calls for each theorem
+// after the search. They must be enabled in satstats().
 bool testpropsearch
     (Database const & database, Prop::size_type const sizelimit,
-     double const parameters[3]);
+     double const parameters[3], class Assstats * stats = NULL,
+     bool printsat = false);
 
 #endif // PROP_H_INCLUDED
@@ -0,0 +1,103 @@
+#include <fstream>
+#include <iostream>
+#include "base.h"
+#include "stats.h"
+
+// Compute the score of an assertion.
+void Assstats::setscore(Assptr pass, Entry const & entry)
+{
+    Assertions::size_type const number(pass->second.number);
+    if (number >= m_scores.size())
+        m_scores.resize(number + 1);
+    m_scores[number] = (entry.proven + 1.) / (entry.tried + 2.);
+}
+
+// Load the statistics from a file. Return true iff okay.
+// A missing file is treated as empty.
+bool Assstats::load(const char * filename, Assertions const & assertions)
+{
+    m_entries.clear();
+    m_scores.clear();
+    std::ifstream in(filename);
+    if (!in.is_open())
+        return true;
+
+    std::string label;
+    Entry entry;
+    while (in >> label >> entry.tried >> entry.proven >> entry.used)
+    {
+        m_entries[label] = entry;
+        Assertions::const_iterator const iter(assertions.find(label.c_str()));
+        if (iter != assertions.end())
+            setscore(&*iter, entry);
+    }
+
+    if (!in.eof())
+    {
+        std::cerr << "Bad entry after " << label << " in statistics "
+                  << filename << std::endl;
+        m_entries.clear();
+        m_scores.clear();
+        return false;
+    }
+
+    return true;
+}
+
+// Save the statistics to a file. Return true iff okay.
+bool Assstats::save(const char * filename) const
+{
+    std::ofstream out(filename);
+    FOR (Map::const_reference entry, m_entries)
+        out << entry.first << ' ' << entry.second.tried << ' '
+            << entry.second.proven << ' ' << entry.second.used << '\n';
+    out.flush();
+
+    if (!out.good())
+    {
+        std::cerr << "Could not write statistics " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Map: assertion -> statistics of a search
+typedef std::map<Assptr, Assstats::Entry> Searchstats;
+
+// Count the moves tried in the subtree of a node.
+static void addtried(SearchBase::TreeNoderef node, Searchstats & stats)
+{
+    if (!SearchBase::isourturn(node))
+    {
+        Move const & move(node.value().game().attempt);
+        if (move.type == Move::ASS)
+        {
+            Assstats::Entry & entry(stats[move.pass]);
+            ++entry.tried;
+            entry.proven += SearchBase::value(node) == WIN;
+        }
+    }
+    FOR (SearchBase::TreeNoderef child, node.get().children)
+        addtried(child, stats);
+}
+
+// Add the statistics of a search, with the proof it found, if any.
+void Assstats::add(SearchBase const & tree, Proofsteps const & proof)
+{
+    Searchstats stats;
+    if (!tree.empty())
+        addtried(tree.root(), stats);
+    FOR (Proofstep step, proof)
+        if (step.type == Proofstep::ASS)
+            ++stats[step.pass].used;
+
+    FOR (Searchstats::const_reference stat, stats)
+    {
+        Entry & entry(m_entries[stat.first->first.c_str]);
+        entry.tried += stat.second.tried;
+        entry.proven += stat.second.proven;
+        entry.used += stat.second.used;
+        setscore(stat.first, entry);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef STATS_H_INCLUDED
+#define STATS_H_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+#include "../proof/step.h"
+
+struct SearchBase;
+
+// Statistics of the usefulness of assertions, learned across searches
+class Assstats
+{
+public:
+    typedef unsigned long Count;
+    struct Entry
+    {
+        // # times a move using the assertion was tried
+        Count tried;
+        // # times such a move led to a proven goal
+        Count proven;
+        // # times the assertion was used in a proof found
+        Count used;
+        Entry() : tried(0), proven(0), used(0) {}
+    };
+private:
+    // Map: label -> statistics
+    typedef std::map<std::string, Entry> Map;
+    Map m_entries;
+    // Scores by assertion #, 0 if not computed
+    std::vector<double> m_scores;
+    // Compute the score of an assertion.
+    void setscore(Assptr pass, Entry const & entry);
+public:
+    // Load the statistics from a file. Return true iff okay.
+    // A missing file is treated as empty.
+    bool load(const char * filename, Assertions const & assertions);
+    // Save the statistics to a file. Return true iff okay.
+    bool save(const char * filename) const;
+    // Add the statistics of a search, with the proof it found, if any.
+    void add(SearchBase const & tree, Proofsteps const & proof);
+    // Score of an assertion, the rate of proven goals with prior 1/2.
+    double score(Assptr pass) const
+    {
+        Assertions::size_type const number(pass->second.number);
+        return number < m_scores.size() && m_scores[number] > 0 ?
+            m_scores[number] : 0.5;
+    }
+    Map::size_type size() const { return m_entries.size(); }
+};
+
+#endif // STATS_H_INCLUDED
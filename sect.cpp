@@ -56,6 +56,18 @@ static Sectionlevel sectionlevel(std::string const & mark)
     return level < maxlevel ? level + 1 : 0;
 }
 
+// If the comment text is a section heading, return its level.
+// Otherwise return 0 ($4.4.1/Headings).
+Sectionlevel headinglevel(std::string const & text)
+{
+    // The first char should be \n.
+    if (text.empty() || text[0] != '\n')
+        return 0;
+    // Get marker.
+    std::string::size_type const end(text.find('\n', 1));
+    return end >= text.size() ? 0 : sectionlevel(text.substr(1, end - 1));
+}
+
 static std::string trim(std::string const & str)
 {
     std::string::size_type const begin(str.find_first_not_of(mmws));
@@ -81,16 +93,14 @@ static Section & addsection(Sections & sections, Sectionlevel const level)
 // Parse section header. Returns true iff there is a header ($4.4.1/Headings).
 static bool parseheader(Comment const & comment, Sections & sections)
 {
-    std::string const & text(comment.text);
-    // The first char should be \n.
-    if (text.empty() || text[0] != '\n')
+    // The level is found when the comment is read.
+    Sectionlevel const level(comment.level);
+    if (level == 0)
         return false;
+    std::string const & text(comment.text);
     // Get marker.
     std::string::size_type end(text.find('\n', 1));
     std::string const mark(text.substr(1, end - 1));
-    Sectionlevel const level(sectionlevel(mark));
-    if (level == 0 || end >= text.size())
-        return false;
     // Get title.
     std::string::size_type const begin(end + 1);
     end = text.find('\n', begin);
@@ -34,6 +34,10 @@ struct Sections : std::map<Sectionnumber, Section>
     Sections(struct Comments const & comments);
 };
 
+// If the comment text is a section heading, return its level.
+// Otherwise return 0 ($4.4.1/Headings).
+Sectionlevel headinglevel(std::string const & text);
+
 std::ostream & operator<<(std::ostream & out, const Sectionnumber & sn);
 std::ostream & operator<<(std::ostream & out, const Section & sect);
 
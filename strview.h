@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <string>
+#include "util/hash.h"
 
 // Lightweight temporary string view, not to outlive viewed string.
 struct strview
@@ -23,5 +24,11 @@ inline bool operator==(strview x, strview y)
 inline bool operator!=(strview x, strview y) { return !(x == y); }
 inline bool operator<(strview x, strview y)
     { return std::strcmp(x.c_str, y.c_str) < 0; }
+// Hash of the viewed string, for hash tables
+struct strviewhash
+{
+    std::size_t operator()(strview x) const
+    { return util::hash(util::hashbasis, x.c_str); }
+};
 
 #endif // STRVIEW_H_INCLUDED
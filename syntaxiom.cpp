@@ -9,6 +9,7 @@
 #include "util.h"
 #include "util/for.h"
 #include "util/iter.h"
+#include "util/parallel.h"
 #include "util/progress.h"
 
 // Map syntax axioms.
@@ -120,7 +121,7 @@ Proofsteps Syntaxioms::rPolish
     if (exp.empty()) return Proofsteps();
 
     Syntaxioms const & filtered(filterbyexp(exp));
-    Subexprecords recs;
+    Subexprecords recs(exp, filtered);
     Substframe::Subexpends const & ends
         (rPolishmap(exp[0], exp.begin() + 1, exp.end(), exp, disjvars,
                     filtered, recs));
@@ -137,8 +138,7 @@ bool Syntaxioms::rPolish
     proofsteps = rPolish(exp, disjvars);
     if (unexpected(proofsteps.empty(), "rPolish error", exp))
         return false;
-    tree = prooftree(proofsteps);
-    if (unexpected(tree.empty(), "rPolish tree error", proofsteps))
+    if (unexpected(!tree.assign(proofsteps), "rPolish tree error", proofsteps))
         return false;
     return true;
 }
@@ -153,9 +153,11 @@ bool Syntaxioms::rPolish
     exp[0] = typecodes.normalize(exp[0]);
     if (!rPolish(exp, ass.disjvars, ass.exprPolish, ass.exptree))
         return false;
+    ass.expmatcher = matchprogram(ass.exprPolish, ass.exptree);
     // Preallocate for efficiency.
     ass.hypsrPolish.resize(ass.hypcount());
     ass.hypstree.resize(ass.hypcount());
+    ass.hypsmatcher.resize(ass.hypcount());
     for (Hypsize i(0); i < ass.hypcount(); ++i)
     {
         Hypiter const iter(ass.hypiters[i]);
@@ -166,7 +168,7 @@ bool Syntaxioms::rPolish
         {
             // Floating hypothesis
             ass.hypsrPolish[i] = Proofsteps(1, &*iter);
-            ass.hypstree[i].assign(1, Prooftreehyps());
+            ass.hypstree[i].assign(ass.hypsrPolish[i]);
         }
         else
         {
@@ -175,6 +177,7 @@ bool Syntaxioms::rPolish
             if (!rPolish(exp,ass.disjvars,ass.hypsrPolish[i],ass.hypstree[i]))
                 return false;
         }
+        ass.hypsmatcher[i] = matchprogram(ass.hypsrPolish[i], ass.hypstree[i]);
     }
 
     return true;
@@ -186,16 +189,27 @@ bool Syntaxioms::rPolish
 {
     Progress progress;
 
-    Assertions::size_type count(0), all(assertions.size());
+    std::vector<Assertions::pointer> passes;
+    passes.reserve(assertions.size());
     FOR (Assertions::reference ass, assertions)
+        passes.push_back(&ass);
+
+    struct Parser
     {
-        if (!rPolish(ass.second, typecodes))
-        {
-            printass(ass, count);
-            std::cerr << "\nSyntax error!" << std::endl;
-            return false;
-        }
-        progress << ++count/static_cast<double>(all);
+        Syntaxioms const & syntaxioms;
+        Typecodes const & typecodes;
+        std::vector<Assertions::pointer> const & passes;
+        bool operator()(std::size_t i) const
+        { return syntaxioms.rPolish(passes[i]->second, typecodes); }
+    } const parser = {*this, typecodes, passes};
+
+    Assertions::size_type const count
+        (util::parallelfor(passes.size(), parser, &progress));
+    if (count < passes.size())
+    {
+        printass(*passes[count], count);
+        std::cerr << "\nSyntax error!" << std::endl;
+        return false;
     }
 
     return true;
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <limits>
+#include <sstream>
 #include "util.h"
 #include "util/arith.h"     // log2
 #include "util/filter.h"    // filter
@@ -9,10 +10,12 @@
 #include "database.h"       // database
 #include "io.h"
 #include "proof/analyze.h"  // checkrPolish
+#include "proof/cache.h"    // Verifycache
 #include "proof/verify.h"   // verifyregularproof
 #include "propctor.h"       // checkpropsat
 #include "stat.h"           // isasshard
 #include "syntaxiom.h"      // checkrPolish
+#include "util/mute.h"      // Mute
 
 template<class T> static T testlog2()
 {
@@ -109,9 +112,45 @@ bool checkassiters
 
 const char * testsat1(); // should be "Okay"
 unsigned testsat2(unsigned n); // should be 0
+unsigned testsat3(unsigned n); // should be 0
+unsigned testsat4(unsigned n); // should be 0
+unsigned testsat5(unsigned n); // should be 0
 bool testDAG(unsigned n); // should be 1
 bool testMCTS(std::size_t sizelimit, double const exploration[2]); // should be 1
 
+// Read a database from the text of a file without comments, quietly.
+// Return true iff okay.
+static bool readtext(Database & database, std::string const & text,
+                     Verifycache & cache)
+{
+    Tokens tokens;
+    std::istringstream in(text);
+    for (Token token; in >> token; )
+        tokens.push_back(token);
+    util::Mute mute;
+    return database.read(tokens, Comments(), tokens.size(), &cache);
+}
+
+// Check if changing a theorem with an incomplete proof makes the proofs
+// using it miss the verification cache. Return true iff okay.
+static bool testcache()
+{
+    static const char header[] = "$c wff |- $. $v ph ps $. wps $f wff ps $. ";
+    static const char uses[] =
+        "lem $p |- ph $= ? $. thm $p |- ps $= wps lem $.";
+    Database db;
+    Verifycache cache;
+    if (!readtext(db, header + std::string("wph $f wff ph $. ") + uses,
+                  cache) || cache.size() != 1)
+        return false;
+    // Rename the hypothesis of lem.
+    cache.rerun();
+    if (!readtext(db, header + std::string("wph1 $f wff ph $. ") + uses,
+                  cache) || cache.size() != 1)
+        return false;
+    return cache.hits() == 0;
+}
+
 bool pretest()
 {
     std::cout << "Checking utilities" << std::endl;
@@ -119,7 +158,12 @@ bool pretest()
         return false;
 
     std::cout << "Checking SAT solvers: " << testsat1() << std::endl;
-    if (testsat2(8) != 0)
+    if (testsat2(8) != 0 || testsat3(10) != 0 || testsat4(16) != 0 ||
+        testsat5(16) != 0)
+        return false;
+
+    std::cout << "Checking verification cache" << std::endl;
+    if (!testcache())
         return false;
 
 //    std::cout << "Checking DAG" << std::endl;
@@ -177,7 +221,7 @@ static bool checkrPolish
         return false;
 
     // Storage for hex names, because hex() points to static storage
-    static Proof hexnums;
+    thread_local static Proof hexnums;
     for (Proofsize i(hexnums.size()); i < rPolish.size(); ++i)
         hexnums.push_back(util::hex(i));
     // Split the proof.
@@ -242,33 +286,49 @@ bool Syntaxioms::checkrPolish
     return true;
 }
 
+#include "util/parallel.h"  // parallelfor
 #include "util/progress.h"  // Progress
 // Test syntax parser. Return 1 iff okay.
 bool Database::checkrPolish() const
 {
     Progress progress;
 
-    Assertions::size_type count(0), all(assertions().size());
+    std::vector<Assertions::const_pointer> passes;
+    passes.reserve(assertions().size());
     FOR (Assertions::const_reference ass, assertions())
+        passes.push_back(&ass);
+
+    struct Checker
     {
-        if (!syntaxioms().checkrPolish(ass.first, ass.second, typecodes()))
+        Database const & database;
+        std::vector<Assertions::const_pointer> const & passes;
+        bool operator()(std::size_t i) const
         {
-            printass(ass, count);
-            std::cerr << "\nSyntax error!" << std::endl;
-            return false;
+            Assertions::const_reference ass(*passes[i]);
+            return database.syntaxioms().checkrPolish
+                    (ass.first, ass.second, database.typecodes());
         }
-        progress << ++count/static_cast<double>(all);
+    } const checker = {*this, passes};
+
+    Assertions::size_type const count
+        (util::parallelfor(passes.size(), checker, &progress));
+    if (count < passes.size())
+    {
+        printass(*passes[count], count);
+        std::cerr << "\nSyntax error!" << std::endl;
+        return false;
     }
 
     return true;
 }
 
-// Check the syntax of the theorem (& all hypotheses). Return true iff okay.
-bool Database::checkpropassertion() const
+// Check all propositional assertions, on all hardware threads.
+// Those with at most maxtruthvars variables are checked by truth tables.
+// Return true iff okay. Otherwise report the first bad one in file order.
+bool Database::checkpropassertion(Atom maxtruthvars) const
 {
-    Assertions::size_type count(0), all(assvec().size());
-
-    for (Assiters::size_type i(1); i < all; ++i)
+    Assiters iters;
+    for (Assiters::size_type i(1); i < assvec().size(); ++i)
     {
         Assiter const iter(assvec()[i]);
         Assertion const & assertion(iter->second);
@@ -278,14 +338,31 @@ bool Database::checkpropassertion() const
             continue; // Skip syntax axioms.
         if (!(assertion.type & Asstype::PROPOSITIONAL))
             continue; // Skip non propositional assertions.
+        iters.push_back(iter);
+    }
 
-        ++count;
-        if (!propctors().checkpropsat(iter->second, iter->second.exprPolish))
+    // Each thread has its own SAT solver.
+    struct Checker
+    {
+        Propctors const & propctors;
+        Assiters const & iters;
+        Atom maxtruthvars;
+        bool operator()(std::size_t i) const
         {
-            printass(*iter);
-            std::cerr << "Logic error!" << std::endl;
-            return false;
+            Assertion const & ass(iters[i]->second);
+            // Confirm a failure by SAT, which prints the counter-model.
+            return propctors.checkproptruth
+                    (ass, ass.exprPolish, maxtruthvars) == 1 ||
+                propctors.checkpropsat(ass, ass.exprPolish);
         }
+    } const checker = {propctors(), iters, maxtruthvars};
+
+    Assiters::size_type const count(util::parallelfor(iters.size(), checker));
+    if (count < iters.size())
+    {
+        printass(*iters[count]);
+        std::cerr << "Logic error!" << std::endl;
+        return false;
     }
 
     return true;
@@ -60,8 +60,8 @@ const char * hex(T n)
 {
     bool const okay(!helper::limits<T>::is_signed);
     int  const padding(sizeof(T[okay ? 3 : -1])/sizeof(T));
-    // Clean space for hex string: ########x0\0
-    char static s[helper::limits<T>::digits / 4 + padding];
+    // Clean space for hex string: ########x0\0, one for each thread
+    thread_local char static s[helper::limits<T>::digits / 4 + padding];
     new(s) char[sizeof(s)]();
     // Fill digits.
     char * i(s);
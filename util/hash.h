@@ -0,0 +1,37 @@
+#ifndef HASH_H_INCLUDED
+#define HASH_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+namespace util
+{
+// 64-bit FNV-1a hash
+typedef unsigned long long Hash;
+static Hash const hashbasis = 14695981039346656037ull;
+static Hash const hashprime = 1099511628211ull;
+
+// Hash n bytes starting at p into h.
+inline Hash hash(Hash h, void const * p, std::size_t n)
+{
+    unsigned char const * s(static_cast<unsigned char const *>(p));
+    for (std::size_t i(0); i < n; ++i)
+        h = (h ^ s[i]) * hashprime;
+    return h;
+}
+// Hash a null-terminated string into h, including the terminator.
+inline Hash hash(Hash h, const char * s)
+{
+    do
+        h = (h ^ static_cast<unsigned char>(*s)) * hashprime;
+    while (*s++);
+    return h;
+}
+inline Hash hash(Hash h, std::string const & s)
+{ return hash(h, s.c_str()); }
+// Hash an integral value into h.
+template<class T> Hash hash(Hash h, T const & n)
+{ return hash(h, &n, sizeof(n)); }
+} // namespace util
+
+#endif // HASH_H_INCLUDED
@@ -0,0 +1,36 @@
+#ifndef MUTE_H_INCLUDED
+#define MUTE_H_INCLUDED
+
+#include <iostream>
+
+namespace util
+{
+// Is the calling thread muted? Threads start unmuted.
+inline bool & muted()
+{
+    thread_local static bool flag(false);
+    return flag;
+}
+
+// Stream for messages from the calling thread,
+// discarding everything while it is muted
+inline std::ostream & msgstream(std::ostream & out)
+{
+    // Stream without a buffer, failing silently on output
+    thread_local static std::ostream null(NULL);
+    return muted() ? null : out;
+}
+inline std::ostream & msgout() { return msgstream(std::cout); }
+inline std::ostream & msgerr() { return msgstream(std::cerr); }
+
+// Mute the calling thread during the lifetime of the object.
+class Mute
+{
+    bool m_old;
+public:
+    Mute() : m_old(muted()) { muted() = true; }
+    ~Mute() { muted() = m_old; }
+};
+} // namespace util
+
+#endif // MUTE_H_INCLUDED
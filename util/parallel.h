@@ -0,0 +1,87 @@
+#ifndef PARALLEL_H_INCLUDED
+#define PARALLEL_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "mute.h"
+#include "progress.h"
+
+namespace util
+{
+// # threads to use: one per hardware thread
+inline unsigned threadcount()
+{
+    unsigned const n(std::thread::hardware_concurrency());
+    return n ? n : 1;
+}
+
+// Call f(i) for i in [0, n) on all hardware threads, until one returns false.
+// Return the least such i, or n if there is none. The threads are muted, so
+// messages via msgout() and msgerr() are only printed for that i,
+// by calling f(i) again after all threads finish.
+// The progress bar is updated as on a single thread.
+template<class F>
+std::size_t parallelfor(std::size_t n, F f, Progress * progress = NULL)
+{
+    unsigned const count(threadcount());
+    if (count == 1 || n <= 1)
+    {
+        for (std::size_t i(0); i < n; ++i)
+        {
+            if (!f(i))
+                return i;
+            if (progress)
+                *progress << (i + 1) / static_cast<double>(n);
+        }
+        return n;
+    }
+
+    // Next index to work on, and least index failed
+    std::atomic<std::size_t> next(0), failed(n), done(0);
+    // Work until the indices run out or go past a failure.
+    // Only the calling thread (with pprogress != NULL) updates the progress bar.
+    struct Worker
+    {
+        static void work(F & f, std::size_t n, std::atomic<std::size_t> & next,
+                         std::atomic<std::size_t> & failed,
+                         std::atomic<std::size_t> & done, Progress * pprogress)
+        {
+            Mute mute;
+            for (std::size_t i; (i = next++) < n && i < failed; )
+            {
+                if (!f(i))
+                {
+                    std::size_t least(failed);
+                    while (i < least && !failed.compare_exchange_weak(least, i))
+                        ;
+                    continue;
+                }
+                std::size_t const finished(++done);
+                if (pprogress && finished < n)
+                    *pprogress << finished / static_cast<double>(n);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i(1); i < count; ++i)
+        threads.push_back(std::thread(Worker::work, std::ref(f), n,
+                                      std::ref(next), std::ref(failed),
+                                      std::ref(done), (Progress *)NULL));
+    Worker::work(f, n, next, failed, done, progress);
+    for (unsigned i(0); i < threads.size(); ++i)
+        threads[i].join();
+
+    if (failed < n)
+        f(failed); // Print the messages.
+    else if (progress)
+        *progress << 1;
+
+    return failed;
+}
+} // namespace util
+
+#endif // PARALLEL_H_INCLUDED
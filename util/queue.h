@@ -0,0 +1,62 @@
+#ifndef QUEUE_H_INCLUDED
+#define QUEUE_H_INCLUDED
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace util
+{
+// Blocking queue of bounded size, for one or more producers and consumers
+template<class T>
+class Boundedqueue
+{
+    std::deque<T> m_items;
+    std::size_t m_capacity;
+    bool m_closed;
+    std::mutex m_mutex;
+    std::condition_variable m_notfull, m_notempty;
+public:
+    Boundedqueue(std::size_t capacity) :
+        m_capacity(capacity ? capacity : 1), m_closed(false) {}
+    // Add an item, waiting while the queue is full.
+    // Return false if the queue has been closed.
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_closed && m_items.size() >= m_capacity)
+            m_notfull.wait(lock);
+        if (m_closed)
+            return false;
+        m_items.push_back(std::move(item));
+        m_notempty.notify_one();
+        return true;
+    }
+    // Remove an item, waiting while the queue is empty.
+    // Return false if the queue has been closed and drained.
+    bool pop(T & item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_closed && m_items.empty())
+            m_notempty.wait(lock);
+        if (m_items.empty())
+            return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notfull.notify_one();
+        return true;
+    }
+    // No more items can be pushed. Waiting threads are woken up.
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notfull.notify_all();
+        m_notempty.notify_all();
+    }
+};
+} // namespace util
+
+#endif // QUEUE_H_INCLUDED
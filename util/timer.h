@@ -1,14 +1,18 @@
 #ifndef TIMER_H_INCLUDED
 #define TIMER_H_INCLUDED
 
-#include <ctime>
+#include <chrono>
+// Wall clock timer, which also measures work done on other threads
 struct Timer
 {
-    std::clock_t start;
-    void reset() { start = std::clock(); }
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start;
+    void reset() { start = Clock::now(); }
     Timer() { reset(); }
-    operator double() const { return resolution() * (std::clock() - start); }
-    static double resolution() { return 1./CLOCKS_PER_SEC; }
+    operator double() const
+    { return std::chrono::duration<double>(Clock::now() - start).count(); }
+    static double resolution()
+    { return static_cast<double>(Clock::period::num) / Clock::period::den; }
 };
 
 #endif // TIMER_H_INCLUDED